@@ -66,7 +66,7 @@ VALUE oci8_get_string_attr(oci8_base_t *base, ub4 attrtype)
     rv = OCIAttrGet(base->hp.ptr, base->type, &val, &size, attrtype, oci8_errhp);
     if (rv != OCI_SUCCESS)
         oci8_raise(oci8_errhp, rv, NULL);
-    return rb_external_str_new_with_enc(TO_CHARPTR(val), size, oci8_encoding);
+    return oci8_make_string(TO_CHARPTR(val), size);
 }
 
 #define MAX_ROWID_LEN 128
@@ -11,10 +11,13 @@
 #endif
 
 static ID id_bind_type;
+static ID id_method;
+static ID id_owner;
 static VALUE sym_length;
 static VALUE sym_length_semantics;
 static VALUE sym_char;
 static VALUE sym_nchar;
+static VALUE sym_truncate;
 
 static VALUE cOCI8BindTypeBase;
 
@@ -23,15 +26,162 @@ typedef struct {
     sb4 bytelen;
     sb4 charlen;
     ub1 csfrm;
+    char keep_truncated; /* true when truncated values are returned instead of nil */
+    /* cache of fetched values. See OCI8::Cursor#string_dedup_size= */
+    VALUE dedup_cache; /* [raw bytes or true, frozen string] pairs or nil */
+    long dedup_mask;
+    long dedup_hits;
+    long dedup_misses;
+    /* size of the inline buffer of dynamic defines or zero.
+     * See OCI8::Cursor#dynamic_string_size= */
+    ub4 dyn_size;
 } oci8_bind_string_t;
 
+/*
+ * An element of a dynamic define. A value is fetched to +buf+ first.
+ * If it doesn't fit, the value is moved to +heap+, which is kept
+ * and reused by later fetches.
+ */
+typedef struct {
+    ub4 piece;  /* length of the last piece, which is set by OCI. */
+    ub4 offset; /* length before the last piece. When it isn't zero, the value is in +heap+. */
+    ub4 capa;   /* allocated size of +heap+ */
+    char *heap;
+    char buf[1];
+} oci8_dvstr_t;
+
+#define DVSTR_PTR(dv) ((dv)->offset ? (dv)->heap : (dv)->buf)
+#define DVSTR_LEN(dv) ((dv)->offset + (dv)->piece)
+#define DVSTR_ELEM(obind, idx) ((oci8_dvstr_t *)((size_t)(obind)->valuep + (obind)->alloc_sz * (idx)))
+
 /*
  * bind_string
  */
+static void bind_string_mark(oci8_base_t *base)
+{
+    oci8_bind_string_t *obs = (oci8_bind_string_t *)base;
+
+    rb_gc_mark(obs->dedup_cache);
+}
+
+/*
+ * Returns a frozen string whose content is +buf+. Strings are cached
+ * in a direct-mapped table indexed by FNV-1a hash of the bytes. A
+ * slot is overwritten when another value is hashed to it.
+ *
+ * A slot is a pair of the fetched bytes and the string. The first
+ * element is +true+ when the string has the fetched bytes as it is,
+ * which is usual. A copy of the bytes is kept only when they are
+ * transcoded.
+ */
+static VALUE bind_string_dedup(oci8_bind_string_t *obs, const char *buf, sb4 size)
+{
+    unsigned long hash = 2166136261UL;
+    VALUE *slot;
+    VALUE key;
+    VALUE str;
+    sb4 idx;
+
+    for (idx = 0; idx < size; idx++) {
+        hash ^= (unsigned char)buf[idx];
+        hash *= 16777619UL;
+    }
+    slot = RARRAY_PTR(obs->dedup_cache) + (hash & obs->dedup_mask) * 2;
+    key = (slot[0] == Qtrue) ? slot[1] : slot[0];
+    if (RTEST(key) && RSTRING_LEN(key) == size && memcmp(RSTRING_PTR(key), buf, size) == 0) {
+        obs->dedup_hits++;
+        return slot[1];
+    }
+    obs->dedup_misses++;
+    str = rb_obj_freeze(oci8_make_string(buf, size));
+    if (RSTRING_LEN(str) == size && memcmp(RSTRING_PTR(str), buf, size) == 0) {
+        key = Qtrue;
+    } else {
+        key = rb_obj_freeze(rb_str_new(buf, size));
+    }
+    idx = (sb4)((hash & obs->dedup_mask) * 2);
+    rb_ary_store(obs->dedup_cache, idx, key);
+    rb_ary_store(obs->dedup_cache, idx + 1, str);
+    return str;
+}
+
 static VALUE bind_string_get(oci8_bind_t *obind, void *data, void *null_struct)
 {
-    oci8_vstr_t *vstr = (oci8_vstr_t *)data;
-    return rb_external_str_new_with_enc(vstr->buf, vstr->size, oci8_encoding);
+    oci8_bind_string_t *obs = (oci8_bind_string_t *)obind;
+    const char *ptr;
+    sb4 size;
+
+    if (obs->dyn_size != 0) {
+        oci8_dvstr_t *dv = (oci8_dvstr_t *)data;
+        ptr = DVSTR_PTR(dv);
+        size = DVSTR_LEN(dv);
+    } else {
+        oci8_vstr_t *vstr = (oci8_vstr_t *)data;
+        ptr = vstr->buf;
+        size = vstr->size;
+    }
+    if (!NIL_P(obs->dedup_cache)) {
+        return bind_string_dedup(obs, ptr, size);
+    }
+    return oci8_make_string(ptr, size);
+}
+
+/*
+ * Makes room for +size+ bytes in the heap buffer of +dv+. This is
+ * called by OCI without GVL. Don't use ruby's memory functions.
+ */
+static int dvstr_reserve(oci8_dvstr_t *dv, ub4 size)
+{
+    ub4 capa = dv->capa ? dv->capa : 64;
+    char *heap;
+
+    if (size <= dv->capa) {
+        return 0;
+    }
+    while (capa < size) {
+        capa *= 2;
+    }
+    heap = realloc(dv->heap, capa);
+    if (heap == NULL) {
+        return -1;
+    }
+    dv->heap = heap;
+    dv->capa = capa;
+    return 0;
+}
+
+/*
+ * OCI calls this for each piece of each row when it fetches a
+ * dynamic define.
+ */
+static sb4 bind_string_define_cb(dvoid *octxp, OCIDefine *defnp, ub4 iter, dvoid **bufpp, ub4 **alenpp, ub1 *piecep, dvoid **indpp, ub2 **rcodepp)
+{
+    oci8_bind_t *obind = (oci8_bind_t *)octxp;
+    oci8_bind_string_t *obs = (oci8_bind_string_t *)obind;
+    oci8_dvstr_t *dv = DVSTR_ELEM(obind, iter);
+
+    if (*piecep == OCI_ONE_PIECE || *piecep == OCI_FIRST_PIECE) {
+        dv->offset = 0;
+        dv->piece = obs->dyn_size;
+        *bufpp = dv->buf;
+    } else {
+        /* The previous piece filled the buffer. Continue in the heap. */
+        ub4 len = DVSTR_LEN(dv);
+
+        if (dvstr_reserve(dv, len + obs->dyn_size) != 0) {
+            return OCI_ERROR;
+        }
+        if (dv->offset == 0) {
+            memcpy(dv->heap, dv->buf, len);
+        }
+        dv->offset = len;
+        dv->piece = dv->capa - len;
+        *bufpp = dv->heap + len;
+    }
+    *alenpp = &dv->piece;
+    *indpp = &obind->u.inds[iter];
+    *rcodepp = NULL;
+    return OCI_CONTINUE;
 }
 
 static void bind_string_set(oci8_bind_t *obind, void *data, void **null_structp, VALUE val)
@@ -43,6 +193,25 @@ static void bind_string_set(oci8_bind_t *obind, void *data, void **null_structp,
     if (RSTRING_LEN(val) > obs->bytelen) {
         rb_raise(rb_eArgError, "too long String to set. (%ld for %d)", RSTRING_LEN(val), obs->bytelen);
     }
+    if (obs->dyn_size != 0) {
+        oci8_dvstr_t *dv = (oci8_dvstr_t *)data;
+        ub4 len = (ub4)RSTRING_LEN(val);
+
+        if (len <= obs->dyn_size) {
+            memcpy(dv->buf, RSTRING_PTR(val), len);
+            dv->offset = 0;
+            dv->piece = len;
+        } else {
+            if (dvstr_reserve(dv, len) != 0) {
+                rb_memerror();
+            }
+            /* The value is in the heap when offset isn't zero. */
+            memcpy(dv->heap, RSTRING_PTR(val), len);
+            dv->offset = obs->dyn_size;
+            dv->piece = len - obs->dyn_size;
+        }
+        return;
+    }
     memcpy(vstr->buf, RSTRING_PTR(val), RSTRING_LEN(val));
     vstr->size = RSTRING_LEN(val);
 }
@@ -55,10 +224,12 @@ static void bind_string_init(oci8_bind_t *obind, VALUE svc, VALUE val, VALUE par
     VALUE nchar;
     sb4 sz;
 
+    obs->dedup_cache = Qnil;
     Check_Type(param, T_HASH);
     length = rb_hash_aref(param, sym_length);
     length_semantics = rb_hash_aref(param, sym_length_semantics);
     nchar = rb_hash_aref(param, sym_nchar);
+    obs->keep_truncated = RTEST(rb_hash_aref(param, sym_truncate));
 
     sz = NUM2INT(length);
     if (sz < 0) {
@@ -92,6 +263,22 @@ static void bind_string_init(oci8_bind_t *obind, VALUE svc, VALUE val, VALUE par
     obind->alloc_sz = (sz + (sizeof(sb4) - 1)) & ~(sizeof(sb4) - 1);
 }
 
+static void bind_string_free(oci8_base_t *base)
+{
+    oci8_bind_t *obind = (oci8_bind_t *)base;
+    oci8_bind_string_t *obs = (oci8_bind_string_t *)base;
+
+    if (obs->dyn_size != 0 && obind->valuep != NULL) {
+        ub4 cnt = obind->maxar_sz ? obind->maxar_sz : 1;
+        ub4 idx;
+
+        for (idx = 0; idx < cnt; idx++) {
+            free(DVSTR_ELEM(obind, idx)->heap);
+        }
+    }
+    oci8_bind_free(base);
+}
+
 static void bind_string_post_bind_hook(oci8_bind_t *obind)
 {
     oci8_bind_string_t *obs = (oci8_bind_string_t *)obind;
@@ -104,8 +291,8 @@ static void bind_string_post_bind_hook(oci8_bind_t *obind)
 
 static const oci8_bind_class_t bind_string_class = {
     {
-        NULL,
-        oci8_bind_free,
+        bind_string_mark,
+        bind_string_free,
         sizeof(oci8_bind_string_t)
     },
     bind_string_get,
@@ -117,6 +304,125 @@ static const oci8_bind_class_t bind_string_class = {
     bind_string_post_bind_hook,
 };
 
+/*
+ * Enables the cache of fetched values with at least +size+ entries
+ * or disables it when +size+ is nil.
+ */
+static VALUE bind_string_set_dedup_size(VALUE self, VALUE size)
+{
+    oci8_bind_string_t *obs = (oci8_bind_string_t *)oci8_get_bind(self);
+    long sz;
+    long capa = 1;
+
+    obs->dedup_hits = 0;
+    obs->dedup_misses = 0;
+    if (NIL_P(size)) {
+        obs->dedup_cache = Qnil;
+        return self;
+    }
+    sz = NUM2LONG(size);
+    if (sz <= 0 || sz > 65536) {
+        rb_raise(rb_eArgError, "out of dedup size range: %ld", sz);
+    }
+    while (capa < sz) {
+        capa *= 2;
+    }
+    obs->dedup_mask = capa - 1;
+    obs->dedup_cache = rb_ary_new2(capa * 2);
+    rb_ary_store(obs->dedup_cache, capa * 2 - 1, Qnil);
+    return self;
+}
+
+/*
+ * Replaces the define buffer with one whose elements have an inline
+ * buffer of +size+ bytes. Longer values are fetched to buffers
+ * allocated on demand. Nothing is changed when +size+ isn't less
+ * than the maximum length.
+ */
+static VALUE bind_string_set_dynamic_size(VALUE self, VALUE size)
+{
+    oci8_bind_t *obind = oci8_get_bind(self);
+    oci8_bind_string_t *obs = (oci8_bind_string_t *)obind;
+    ub4 cnt = obind->maxar_sz ? obind->maxar_sz : 1;
+    long sz = NUM2LONG(size);
+    sb4 maxlen = obind->value_sz - (sb4)sizeof(sb4);
+
+    if (obind->base.hp.ptr != NULL) {
+        rb_raise(rb_eRuntimeError, "cannot change the buffer of a bound or defined value");
+    }
+    if (obs->dyn_size != 0) {
+        rb_raise(rb_eRuntimeError, "dynamic size is already set");
+    }
+    if (sz <= 0) {
+        rb_raise(rb_eArgError, "out of dynamic size range: %ld", sz);
+    }
+    if (sz >= maxlen) {
+        return self;
+    }
+    xfree(obind->valuep);
+    obind->valuep = NULL;
+    obind->value_sz = maxlen;
+    obind->alloc_sz = (offsetof(oci8_dvstr_t, buf) + sz + (sizeof(void *) - 1)) & ~(sizeof(void *) - 1);
+    obind->valuep = xmalloc(obind->alloc_sz * cnt);
+    memset(obind->valuep, 0, obind->alloc_sz * cnt);
+    memset(obind->u.inds, -1, sizeof(sb2) * cnt);
+    obs->dyn_size = (ub4)sz;
+    return self;
+}
+
+/*
+ * Returns true when +obind+ is a string define fetched by callbacks.
+ */
+int oci8_bind_string_is_dynamic(const oci8_bind_t *obind)
+{
+    const oci8_bind_class_t *obc = (const oci8_bind_class_t *)obind->base.klass;
+
+    return obc->get == bind_string_get && ((const oci8_bind_string_t *)obind)->dyn_size != 0;
+}
+
+/*
+ * Registers the callback of a define created with OCI_DYNAMIC_FETCH.
+ */
+sword oci8_bind_string_define_dynamic(oci8_bind_t *obind)
+{
+    return OCIDefineDynamic(obind->base.hp.dfn, oci8_errhp, obind, bind_string_define_cb);
+}
+
+/*
+ * Returns the number of bytes allocated for the values and indicators
+ * of +obind+, including heap buffers of dynamic defines.
+ */
+size_t oci8_bind_bytes_allocated(const oci8_bind_t *obind)
+{
+    ub4 cnt = obind->maxar_sz ? obind->maxar_sz : 1;
+    size_t size = (size_t)obind->alloc_sz * cnt;
+
+    size += NIL_P(obind->tdo) ? sizeof(sb2) * cnt : sizeof(void *) * cnt;
+    if (oci8_bind_string_is_dynamic(obind)) {
+        ub4 idx;
+
+        for (idx = 0; idx < cnt; idx++) {
+            size += DVSTR_ELEM(obind, idx)->capa;
+        }
+    }
+    return size;
+}
+
+/*
+ * Returns [hits, misses] of the cache of fetched values or nil when
+ * +obind+ doesn't use it.
+ */
+VALUE oci8_bind_string_dedup_stats(oci8_bind_t *obind)
+{
+    const oci8_bind_class_t *obc = (const oci8_bind_class_t *)obind->base.klass;
+    oci8_bind_string_t *obs = (oci8_bind_string_t *)obind;
+
+    if (obc->get != bind_string_get || NIL_P(obs->dedup_cache)) {
+        return Qnil;
+    }
+    return rb_ary_new3(2, LONG2NUM(obs->dedup_hits), LONG2NUM(obs->dedup_misses));
+}
+
 /*
  * bind_raw
  */
@@ -190,44 +496,41 @@ static const oci8_bind_class_t bind_binary_double_class = {
     SQLT_BDOUBLE
 };
 
-static VALUE oci8_bind_get(VALUE self)
+/*
+ * Returns true when the idx-th element of +obind+ is NULL or a value
+ * which cannot be returned. A positive indicator or -2 means that the
+ * value was truncated. It is returned only by binds created with
+ * <tt>:truncate => true</tt>, such as OCI8::BindType::CLOBAsString.
+ */
+int oci8_bind_is_null(const oci8_bind_t *obind, ub4 idx)
 {
-    oci8_bind_t *obind = DATA_PTR(self);
     const oci8_bind_class_t *obc = (const oci8_bind_class_t *)obind->base.klass;
-    ub4 idx = obind->curar_idx;
-    void **null_structp = NULL;
+    sb2 ind = obind->u.inds[idx];
 
-    if (NIL_P(obind->tdo)) {
-        if (obind->u.inds[idx] != 0)
-            return Qnil;
+    if (ind == 0) {
+        return 0;
     }
-    return obc->get(obind, (void*)((size_t)obind->valuep + obind->alloc_sz * idx), null_structp);
+    if (ind != -1 && (obc->get == bind_string_get || obc->get == bind_raw_get)) {
+        return !((const oci8_bind_string_t *)obind)->keep_truncated;
+    }
+    return 1;
 }
 
-VALUE oci8_bind_get_data(VALUE self)
+static VALUE bind_get_elem(oci8_bind_t *obind, ub4 idx)
 {
-    oci8_bind_t *obind = DATA_PTR(self);
-
-    if (obind->maxar_sz == 0) {
-        obind->curar_idx = 0;
-        return rb_funcall(self, oci8_id_get, 0);
-    } else {
-        volatile VALUE ary = rb_ary_new2(obind->curar_sz);
-        ub4 idx;
+    const oci8_bind_class_t *obc = (const oci8_bind_class_t *)obind->base.klass;
+    void **null_structp = NULL;
 
-        for (idx = 0; idx < obind->curar_sz; idx++) {
-            obind->curar_idx = idx;
-            rb_ary_store(ary, idx, rb_funcall(self, oci8_id_get, 0));
-        }
-        return ary;
+    if (NIL_P(obind->tdo)) {
+        if (oci8_bind_is_null(obind, idx))
+            return Qnil;
     }
+    return obc->get(obind, (void*)((size_t)obind->valuep + obind->alloc_sz * idx), null_structp);
 }
 
-static VALUE oci8_bind_set(VALUE self, VALUE val)
+static void bind_set_elem(oci8_bind_t *obind, ub4 idx, VALUE val)
 {
-    oci8_bind_t *obind = DATA_PTR(self);
     const oci8_bind_class_t *obc = (const oci8_bind_class_t *)obind->base.klass;
-    ub4 idx = obind->curar_idx;
 
     if (NIL_P(val)) {
         if (NIL_P(obind->tdo)) {
@@ -247,16 +550,87 @@ static VALUE oci8_bind_set(VALUE self, VALUE val)
         }
         obc->set(obind, (void*)((size_t)obind->valuep + obind->alloc_sz * idx), null_structp, val);
     }
+}
+
+/*
+ * Returns true when +mid+ of the bind object isn't overridden
+ * in ruby, so that the C function can be called directly.
+ */
+static int bind_method_is_builtin(VALUE self, ID mid)
+{
+    VALUE method = rb_funcall(self, id_method, 1, ID2SYM(mid));
+
+    if (!rb_respond_to(method, id_owner)) {
+        /* Method#owner isn't available in ruby 1.8.6. */
+        return 0;
+    }
+    return rb_funcall(method, id_owner, 0) == cOCI8BindTypeBase;
+}
+
+static VALUE oci8_bind_get(VALUE self)
+{
+    oci8_bind_t *obind = DATA_PTR(self);
+
+    return bind_get_elem(obind, obind->curar_idx);
+}
+
+VALUE oci8_bind_get_data(VALUE self)
+{
+    oci8_bind_t *obind = DATA_PTR(self);
+
+    if (obind->maxar_sz == 0) {
+        return oci8_bind_get_elem(self, 0);
+    } else {
+        volatile VALUE ary = rb_ary_new2(obind->curar_sz);
+        ub4 idx;
+
+        for (idx = 0; idx < obind->curar_sz; idx++) {
+            rb_ary_store(ary, idx, oci8_bind_get_elem(self, idx));
+        }
+        return ary;
+    }
+}
+
+/*
+ * Gets the idx-th element of a define array.
+ */
+VALUE oci8_bind_get_elem(VALUE self, ub4 idx)
+{
+    oci8_bind_t *obind = DATA_PTR(self);
+
+    obind->curar_idx = idx;
+    if (obind->builtin_get) {
+        return bind_get_elem(obind, idx);
+    }
+    return rb_funcall(self, oci8_id_get, 0);
+}
+
+static VALUE oci8_bind_set(VALUE self, VALUE val)
+{
+    oci8_bind_t *obind = DATA_PTR(self);
+
+    bind_set_elem(obind, obind->curar_idx, val);
     return self;
 }
 
+static void oci8_bind_set_elem(VALUE self, ub4 idx, VALUE val)
+{
+    oci8_bind_t *obind = DATA_PTR(self);
+
+    obind->curar_idx = idx;
+    if (obind->builtin_set) {
+        bind_set_elem(obind, idx, val);
+    } else {
+        rb_funcall(self, oci8_id_set, 1, val);
+    }
+}
+
 void oci8_bind_set_data(VALUE self, VALUE val)
 {
     oci8_bind_t *obind = DATA_PTR(self);
 
     if (obind->maxar_sz == 0) {
-        obind->curar_idx = 0;
-        rb_funcall(self, oci8_id_set, 1, val);
+        oci8_bind_set_elem(self, 0, val);
     } else {
         ub4 size;
         ub4 idx;
@@ -267,8 +641,7 @@ void oci8_bind_set_data(VALUE self, VALUE val)
             rb_raise(rb_eRuntimeError, "over the max array size");
         }
         for (idx = 0; idx < size; idx++) {
-            obind->curar_idx = idx;
-            rb_funcall(self, oci8_id_set, 1, RARRAY_PTR(val)[idx]);
+            oci8_bind_set_elem(self, idx, RARRAY_PTR(val)[idx]);
         }
         obind->curar_sz = size;
     }
@@ -281,6 +654,8 @@ static VALUE oci8_bind_initialize(VALUE self, VALUE svc, VALUE val, VALUE length
     ub4 cnt = 1;
 
     obind->tdo = Qnil;
+    obind->builtin_get = bind_method_is_builtin(self, oci8_id_get);
+    obind->builtin_set = bind_method_is_builtin(self, oci8_id_set);
     obind->maxar_sz = NIL_P(max_array_size) ? 0 : NUM2UINT(max_array_size);
     obind->curar_sz = 0;
     if (obind->maxar_sz > 0)
@@ -337,19 +712,26 @@ void oci8_bind_hp_obj_mark(oci8_base_t *base)
 
 void Init_oci8_bind(VALUE klass)
 {
+    VALUE cOCI8BindTypeString;
+
     cOCI8BindTypeBase = klass;
     id_bind_type = rb_intern("bind_type");
+    id_method = rb_intern("method");
+    id_owner = rb_intern("owner");
     sym_length = ID2SYM(rb_intern("length"));
     sym_length_semantics = ID2SYM(rb_intern("length_semantics"));
     sym_char = ID2SYM(rb_intern("char"));
     sym_nchar = ID2SYM(rb_intern("nchar"));
+    sym_truncate = ID2SYM(rb_intern("truncate"));
 
     rb_define_method(cOCI8BindTypeBase, "initialize", oci8_bind_initialize, 4);
     rb_define_method(cOCI8BindTypeBase, "get", oci8_bind_get, 0);
     rb_define_method(cOCI8BindTypeBase, "set", oci8_bind_set, 1);
 
     /* register primitive data types. */
-    oci8_define_bind_class("String", &bind_string_class);
+    cOCI8BindTypeString = oci8_define_bind_class("String", &bind_string_class);
+    rb_define_private_method(cOCI8BindTypeString, "__set_dedup_size", bind_string_set_dedup_size, 1);
+    rb_define_private_method(cOCI8BindTypeString, "__set_dynamic_size", bind_string_set_dynamic_size, 1);
     oci8_define_bind_class("RAW", &bind_raw_class);
     if (oracle_client_version >= ORAVER_10_1) {
         oci8_define_bind_class("BinaryDouble", &bind_binary_double_class);
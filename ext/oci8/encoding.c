@@ -263,6 +263,65 @@ static VALUE oci8_set_encoding(VALUE klass, VALUE encoding)
     }
     return encoding;
 }
+
+/* 0x8080...80: the highest bit of each byte in a word */
+#define ASCII_MASK (((size_t)-1 / 0xFF) * 0x80)
+
+/* Returns true when all bytes are ASCII. Checks a word at a time. */
+static int is_ascii_only(const char *ptr, long len)
+{
+    const char *end = ptr + len;
+    size_t word;
+
+    while (ptr < end && ((size_t)ptr % sizeof(size_t)) != 0) {
+        if (*ptr & 0x80) {
+            return 0;
+        }
+        ptr++;
+    }
+    while (ptr + sizeof(size_t) <= end) {
+        memcpy(&word, ptr, sizeof(size_t));
+        if (word & ASCII_MASK) {
+            return 0;
+        }
+        ptr += sizeof(size_t);
+    }
+    while (ptr < end) {
+        if (*ptr & 0x80) {
+            return 0;
+        }
+        ptr++;
+    }
+    return 1;
+}
+
+/*
+ * Makes a string in OCI8.encoding from data fetched from Oracle.
+ *
+ * When no encoding conversion is needed, the string is made
+ * directly and its code range is set if it is ASCII only, which
+ * saves a scan later.
+ */
+VALUE oci8_make_string(const char *ptr, long len)
+{
+    rb_encoding *internal = rb_default_internal_encoding();
+    VALUE str;
+
+    if (oci8_encoding == NULL || (internal != NULL && internal != oci8_encoding)
+        || !rb_enc_asciicompat(oci8_encoding)) {
+        return rb_external_str_new_with_enc(ptr, len, oci8_encoding);
+    }
+    str = rb_str_new(ptr, len);
+    OBJ_TAINT(str); /* as rb_external_str_new_with_enc() does. */
+    rb_enc_associate(str, oci8_encoding);
+    if (is_ascii_only(ptr, len)) {
+        ENC_CODERANGE_SET(str, ENC_CODERANGE_7BIT);
+    } else if (oci8_encoding == rb_usascii_encoding()) {
+        /* Same with rb_external_str_new_with_enc(). */
+        rb_enc_associate(str, rb_ascii8bit_encoding());
+    }
+    return str;
+}
 #endif
 
 void Init_oci8_encoding(VALUE cOCI8)
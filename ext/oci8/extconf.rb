@@ -118,6 +118,10 @@ have_type("rb_blocking_function_t*", "ruby.h")
 have_func("rb_set_end_proc", "ruby.h")
 have_func("rb_class_superclass", "ruby.h")
 have_func("rb_thread_blocking_region", "ruby.h")
+have_func("rb_integer_pack", "ruby.h") # ruby 2.1
+have_func("rb_time_nano_new", "ruby.h") # ruby 1.9
+have_func("rb_time_timespec_new", "ruby.h") # ruby 2.3
+have_func("rb_hash_new_capa", "ruby.h") # ruby 3.2
 
 # replace files
 replace = {
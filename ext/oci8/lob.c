@@ -4,6 +4,7 @@
 static ID id_plus;
 static ID id_dir_alias;
 static ID id_filename;
+static ID id_read;
 static VALUE cOCI8LOB;
 static VALUE cOCI8CLOB;
 static VALUE cOCI8NCLOB;
@@ -29,6 +30,9 @@ typedef struct {
     ub1 csfrm;
     ub1 lobtype;
     enum state state;
+    ub4 chunk_size; /* cached chunk size. zero when it isn't got yet. */
+    ub4 length; /* cached length. valid only when length_is_cached is true. */
+    char length_is_cached;
 } oci8_lob_t;
 
 static VALUE oci8_lob_write(VALUE self, VALUE data);
@@ -121,13 +125,27 @@ static oci8_base_class_t oci8_lob_class = {
 
 static ub4 oci8_lob_get_length(oci8_lob_t *lob)
 {
-    oci8_svcctx_t *svcctx = oci8_get_svcctx(lob->svc);
+    oci8_svcctx_t *svcctx;
     ub4 len;
 
+    if (lob->length_is_cached) {
+        return lob->length;
+    }
+    svcctx = oci8_get_svcctx(lob->svc);
     oci_lc(OCILobGetLength_nb(svcctx, svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, &len));
+    lob->length = len;
+    lob->length_is_cached = 1;
     return len;
 }
 
+/* update the cached length after data are written up to lob->pos. */
+static void lob_update_length(oci8_lob_t *lob)
+{
+    if (lob->length_is_cached && lob->length < lob->pos) {
+        lob->length = lob->pos;
+    }
+}
+
 static void lob_open(oci8_lob_t *lob)
 {
     if (lob->state == S_CLOSE) {
@@ -187,6 +205,8 @@ static VALUE oci8_lob_do_initialize(int argc, VALUE *argv, VALUE self, ub1 csfrm
     lob->svchp = NULL;
     lob->pos = 0;
     lob->char_width = 1;
+    lob->chunk_size = 0;
+    lob->length_is_cached = 0;
     lob->csfrm = csfrm;
     lob->lobtype = lobtype;
     lob->state = S_NO_OPEN_CLOSE;
@@ -303,6 +323,8 @@ static VALUE oci8_lob_truncate(VALUE self, VALUE len)
 
     lob_open(lob);
     oci_lc(OCILobTrim_nb(svcctx, svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, NUM2UINT(len)));
+    lob->length = NUM2UINT(len);
+    lob->length_is_cached = 1;
     return self;
 }
 
@@ -312,36 +334,70 @@ static VALUE oci8_lob_set_size(VALUE self, VALUE len)
     return len;
 }
 
-static VALUE oci8_lob_read(int argc, VALUE *argv, VALUE self)
+/* the piece size used when the chunk size is unavailable. */
+#define DEFAULT_PIECE_SIZE 8192
+
+/*
+ * Returns the size of a buffer passed to each OCILobRead call to read
+ * +nchar+ characters or bytes. It is the chunk size of the LOB in bytes.
+ * The chunk size isn't got for reads which fit within the default piece
+ * size because it needs a server round trip.
+ */
+static ub4 lob_piece_size(oci8_lob_t *lob, ub4 nchar)
 {
-    oci8_lob_t *lob = DATA_PTR(self);
-    oci8_svcctx_t *svcctx = oci8_get_svcctx(lob->svc);
-    ub4 length;
+    if (lob->chunk_size == 0 && (double)nchar * lob->char_width <= DEFAULT_PIECE_SIZE) {
+        return DEFAULT_PIECE_SIZE;
+    }
+    if (lob->chunk_size == 0) {
+        if (have_OCILobGetChunkSize_nb && lob->state != S_BFILE_CLOSE && lob->state != S_BFILE_OPEN) {
+            oci8_svcctx_t *svcctx = oci8_get_svcctx(lob->svc);
+            ub4 len;
+
+            oci_lc(OCILobGetChunkSize_nb(svcctx, svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, &len));
+            lob->chunk_size = len;
+        }
+        if (lob->chunk_size == 0) {
+            lob->chunk_size = DEFAULT_PIECE_SIZE;
+        }
+    }
+    if (lob->lobtype == OCI_TEMP_CLOB) {
+        /* the chunk size of CLOBs is in characters. */
+        return lob->chunk_size * oci8_nls_ratio * lob->char_width;
+    }
+    return lob->chunk_size;
+}
+
+typedef struct {
+    oci8_lob_t *lob;
+    oci8_svcctx_t *svcctx;
+    VALUE v;
     ub4 nchar;
-    ub4 amt;
+    ub4 piece_size;
+    long capa;
+    long len;
+    int locked;
+} lob_read_arg_t;
+
+/*
+ * Reads data into arg->v. arg->v is locked while OCI writes into it
+ * because OCILobRead_nb may run without GVL and arg->v may be a
+ * String passed by the caller.
+ */
+static VALUE lob_read_body(VALUE data)
+{
+    lob_read_arg_t *arg = (lob_read_arg_t *)data;
+    oci8_lob_t *lob = arg->lob;
+    ub4 piece_size = arg->piece_size;
+    ub4 amt = arg->nchar;
     sword rv;
-    char buf[8192];
-    size_t buf_size_in_char;
-    VALUE size;
-    VALUE v = rb_ary_new();
+    char *buf;
+    ub4 buf_size;
 
-    rb_scan_args(argc, argv, "01", &size);
-    length = oci8_lob_get_length(lob);
-    if (length <= lob->pos) /* EOF */
-        return Qnil;
-    length -= lob->pos;
-    if (NIL_P(size)) {
-        nchar = length; /* read until EOF */
-    } else {
-        nchar = NUM2UINT(size);
-        if (nchar > length)
-            nchar = length;
-    }
-    amt = nchar;
-    buf_size_in_char = sizeof(buf) / lob->char_width;
+    rb_str_locktmp(arg->v);
+    arg->locked = 1;
     do {
         if (lob->state == S_BFILE_CLOSE) {
-            rv = OCILobFileOpen_nb(svcctx, svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, OCI_FILE_READONLY);
+            rv = OCILobFileOpen_nb(arg->svcctx, arg->svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, OCI_FILE_READONLY);
             if (rv == OCI_ERROR && oci8_get_error_code(oci8_errhp) == 22290) {
                 /* ORA-22290: operation would exceed the maximum number of opened files or LOBs */
                 /* close all opened BFILE implicitly. */
@@ -354,16 +410,29 @@ static VALUE oci8_lob_read(int argc, VALUE *argv, VALUE self)
                         }
                     }
                 }
-                oci_lc(OCILobFileCloseAll_nb(svcctx, svcctx->base.hp.svc, oci8_errhp));
+                oci_lc(OCILobFileCloseAll_nb(arg->svcctx, arg->svcctx->base.hp.svc, oci8_errhp));
                 continue;
             }
             if (rv != OCI_SUCCESS)
                 oci8_raise(oci8_errhp, rv, NULL);
             lob->state = S_BFILE_OPEN;
         }
-        /* initialize buf in zeros everytime to check a nul characters. */
-        memset(buf, 0, sizeof(buf));
-        rv = OCILobRead_nb(svcctx, svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, &amt, lob->pos + 1, buf, sizeof(buf), NULL, NULL, 0, lob->csfrm);
+        if (lob->lobtype == OCI_TEMP_CLOB && arg->capa - arg->len < (long)piece_size) {
+            arg->capa = (arg->capa * 2 > arg->len + (long)piece_size) ? arg->capa * 2 : arg->len + (long)piece_size;
+            /* a locked string cannot be resized. */
+            rb_str_unlocktmp(arg->v);
+            arg->locked = 0;
+            rb_str_resize(arg->v, arg->capa);
+            rb_str_locktmp(arg->v);
+            arg->locked = 1;
+        }
+        buf = RSTRING_PTR(arg->v) + arg->len;
+        buf_size = (arg->capa - arg->len < (long)piece_size) ? (ub4)(arg->capa - arg->len) : piece_size;
+        if (lob->lobtype == OCI_TEMP_CLOB) {
+            /* initialize buf in zeros everytime to check a nul characters. */
+            memset(buf, 0, buf_size);
+        }
+        rv = OCILobRead_nb(arg->svcctx, arg->svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, &amt, lob->pos + 1, buf, buf_size, NULL, NULL, 0, lob->csfrm);
         if (rv == OCI_ERROR && oci8_get_error_code(oci8_errhp) == 22289) {
             /* ORA-22289: cannot perform FILEREAD operation on an unopened file or LOB */
             if (lob->state == S_BFILE_CLOSE)
@@ -372,41 +441,134 @@ static VALUE oci8_lob_read(int argc, VALUE *argv, VALUE self)
         if (rv != OCI_SUCCESS && rv != OCI_NEED_DATA)
             oci8_raise(oci8_errhp, rv, NULL);
 
-        /* Workaround when using Oracle 10.2.0.4 or 11.1.0.6 client and
-         * variable-length character set (e.g. AL32UTF8).
-         *
-         * When the above mentioned condition, amt may be shorter. So
-         * amt is increaded until a nul character to know the actually
-         * read size.
-         */
-        while (amt < sizeof(buf) && buf[amt] != '\0') {
-            amt++;
+        if (lob->lobtype == OCI_TEMP_CLOB) {
+            /* Workaround when using Oracle 10.2.0.4 or 11.1.0.6 client and
+             * variable-length character set (e.g. AL32UTF8).
+             *
+             * When the above mentioned condition, amt may be shorter. So
+             * amt is increaded until a nul character to know the actually
+             * read size.
+             */
+            while (amt < buf_size && buf[amt] != '\0') {
+                amt++;
+            }
         }
 
         if (amt == 0)
             break;
         /* for fixed size charset, amt is the number of characters stored in buf. */
-        if (amt > buf_size_in_char)
+        if (amt > buf_size / lob->char_width)
             rb_raise(eOCIException, "Too large buffer fetched or you set too large size of a character.");
-        amt *= lob->char_width;
-        rb_ary_push(v, rb_str_new(buf, amt));
+        arg->len += amt * lob->char_width;
     } while (rv == OCI_NEED_DATA);
+    return Qnil;
+}
+
+static VALUE lob_read_ensure(VALUE data)
+{
+    lob_read_arg_t *arg = (lob_read_arg_t *)data;
+
+    if (arg->locked) {
+        rb_str_unlocktmp(arg->v);
+        arg->locked = 0;
+    }
+    return Qnil;
+}
+
+/*
+ * call-seq:
+ *   read(size = nil, outbuf = nil) -> string or nil
+ *
+ * Reads +size+ characters (CLOB and NCLOB) or bytes (BLOB and BFILE)
+ * from the current position. It reads until the end of the LOB when
+ * +size+ is +nil+. It returns +nil+ at the end of the LOB.
+ *
+ * When +outbuf+ is given, read data is stored into it directly and
+ * it is returned. Reading into a reused +outbuf+ doesn't allocate
+ * a new String every time.
+ *
+ * example:
+ *   buf = ''
+ *   while blob.read(1024 * 1024, buf)
+ *     io.write(buf)
+ *   end
+ */
+static VALUE oci8_lob_read(int argc, VALUE *argv, VALUE self)
+{
+    oci8_lob_t *lob = DATA_PTR(self);
+    oci8_svcctx_t *svcctx = oci8_get_svcctx(lob->svc);
+    ub4 length;
+    ub4 nchar;
+    ub4 piece_size;
+    long capa;
+    long len;
+    lob_read_arg_t arg;
+    VALUE size;
+    VALUE outbuf;
+    volatile VALUE v;
+
+    rb_scan_args(argc, argv, "02", &size, &outbuf);
+    if (!NIL_P(outbuf)) {
+        StringValue(outbuf);
+        rb_str_modify(outbuf);
+    }
+    length = oci8_lob_get_length(lob);
+    if (length <= lob->pos) { /* EOF */
+        if (!NIL_P(outbuf)) {
+            rb_str_resize(outbuf, 0);
+        }
+        return Qnil;
+    }
+    length -= lob->pos;
+    if (NIL_P(size)) {
+        nchar = length; /* read until EOF */
+    } else {
+        nchar = NUM2UINT(size);
+        if (nchar > length)
+            nchar = length;
+    }
+    if (nchar == 0) {
+        return NIL_P(outbuf) ? rb_str_new(NULL, 0) : rb_str_resize(outbuf, 0);
+    }
+    piece_size = lob_piece_size(lob, nchar);
+    /* For BLOBs and BFILEs, nchar is the exact number of bytes to be read.
+     * For CLOBs, the buffer is extended when it becomes short.
+     */
+    capa = (long)nchar * lob->char_width;
+    arg.lob = lob;
+    arg.svcctx = svcctx;
+    arg.v = v = NIL_P(outbuf) ? rb_str_new(NULL, capa) : rb_str_resize(outbuf, capa);
+    arg.nchar = nchar;
+    arg.piece_size = piece_size;
+    arg.capa = capa;
+    arg.len = 0;
+    arg.locked = 0;
+    rb_ensure(lob_read_body, (VALUE)&arg, lob_read_ensure, (VALUE)&arg);
+    len = arg.len;
     lob->pos += nchar;
     if (nchar == length) {
         lob_close(lob);
         bfile_close(lob);
     }
-    if (RARRAY_LEN(v) == 0) {
+    rb_str_resize(v, len);
+    if (len == 0) {
         return Qnil;
     }
-    v = rb_ary_join(v, Qnil);
     OBJ_TAINT(v);
     if (lob->lobtype == OCI_TEMP_CLOB) {
+        VALUE str;
+
         /* set encoding */
         rb_enc_associate(v, oci8_encoding);
-        return rb_str_conv_enc(v, oci8_encoding, rb_default_internal_encoding());
+        str = rb_str_conv_enc(v, oci8_encoding, rb_default_internal_encoding());
+        if (str != v && !NIL_P(outbuf)) {
+            rb_str_replace(outbuf, str);
+            return outbuf;
+        }
+        return str;
     } else {
         /* ASCII-8BIT */
+        rb_enc_associate(v, rb_ascii8bit_encoding());
         return v;
     }
 }
@@ -428,9 +590,189 @@ static VALUE oci8_lob_write(VALUE self, VALUE data)
     amt = RSTRING_LEN(data);
     oci_lc(OCILobWrite_nb(svcctx, svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, &amt, lob->pos + 1, RSTRING_PTR(data), amt, OCI_ONE_PIECE, NULL, NULL, 0, lob->csfrm));
     lob->pos += amt;
+    lob_update_length(lob);
     return UINT2NUM(amt);
 }
 
+typedef struct {
+    oci8_lob_t *lob;
+    oci8_svcctx_t *svcctx;
+    VALUE io;
+    VALUE piece_size;
+    VALUE bufs[2]; /* output buffers passed to io.read alternately */
+    VALUE cur;     /* data to be written */
+    VALUE next;    /* data read ahead to know whether cur is the last piece */
+    ub4 amt;
+    int in_piecewise; /* true after OCI_FIRST_PIECE is sent until the last piece. */
+} write_stream_arg_t;
+
+/* Returns a String read from the IO or nil at EOF. */
+static VALUE write_stream_read(write_stream_arg_t *arg, int idx)
+{
+    VALUE str = rb_funcall(arg->io, id_read, 2, arg->piece_size, arg->bufs[idx]);
+
+    if (NIL_P(str)) {
+        return Qnil;
+    }
+    StringValue(str);
+    return RSTRING_LEN(str) != 0 ? str : Qnil;
+}
+
+/*
+ * Returns the length of +str+ without an incomplete character at the
+ * end, which must be written along with the next piece.
+ */
+static long write_stream_complete_len(oci8_lob_t *lob, VALUE str)
+{
+#ifdef HAVE_TYPE_RB_ENCODING
+    if (lob->lobtype == OCI_TEMP_CLOB && oci8_encoding != NULL) {
+        char *s = RSTRING_PTR(str);
+        char *e = s + RSTRING_LEN(str);
+        char *p = (char *)rb_enc_left_char_head(s, e - 1, e, oci8_encoding);
+
+        if (MBCLEN_NEEDMORE_P(rb_enc_precise_mbclen(p, e, oci8_encoding))) {
+            return p - s;
+        }
+    }
+#endif
+    return RSTRING_LEN(str);
+}
+
+static VALUE write_stream_body(VALUE varg)
+{
+    write_stream_arg_t *arg = (write_stream_arg_t *)varg;
+    oci8_lob_t *lob = arg->lob;
+    oci8_svcctx_t *svcctx = arg->svcctx;
+    ub1 piece = OCI_FIRST_PIECE;
+    int idx = 0;
+    long len;
+    sword rv;
+
+    arg->cur = write_stream_read(arg, idx);
+    if (NIL_P(arg->cur)) {
+        return Qnil;
+    }
+    for (;;) {
+        idx = 1 - idx;
+        arg->next = write_stream_read(arg, idx);
+        len = RSTRING_LEN(arg->cur);
+        if (NIL_P(arg->next)) {
+            /* cur is the last piece. */
+            if (piece == OCI_FIRST_PIECE) {
+                piece = OCI_ONE_PIECE;
+                arg->amt = (ub4)len;
+            } else {
+                piece = OCI_LAST_PIECE;
+            }
+        } else {
+            long clen = write_stream_complete_len(lob, arg->cur);
+
+            if (clen != len) {
+                /* move an incomplete character to the next piece. */
+                VALUE str = rb_str_buf_new(len - clen + RSTRING_LEN(arg->next));
+                rb_str_buf_cat(str, RSTRING_PTR(arg->cur) + clen, len - clen);
+                rb_str_buf_cat(str, RSTRING_PTR(arg->next), RSTRING_LEN(arg->next));
+                arg->next = str;
+                len = clen;
+            }
+            if (len == 0) {
+                arg->cur = arg->next;
+                continue;
+            }
+        }
+        if (piece != OCI_ONE_PIECE) {
+            arg->in_piecewise = 1;
+        }
+        rv = OCILobWrite_nb(svcctx, svcctx->base.hp.svc, oci8_errhp, lob->base.hp.lob, &arg->amt, lob->pos + 1, RSTRING_PTR(arg->cur), (ub4)len, piece, NULL, NULL, 0, lob->csfrm);
+        if (piece == OCI_ONE_PIECE || piece == OCI_LAST_PIECE) {
+            if (rv != OCI_SUCCESS)
+                oci8_raise(oci8_errhp, rv, NULL);
+            arg->in_piecewise = 0;
+            break;
+        }
+        if (rv != OCI_NEED_DATA)
+            oci8_raise(oci8_errhp, rv, NULL);
+        piece = OCI_NEXT_PIECE;
+        arg->cur = arg->next;
+    }
+    return Qnil;
+}
+
+/*
+ * call-seq:
+ *   write_stream(io) -> integer
+ *
+ * Reads data from +io+ until EOF and writes it to the LOB at the
+ * current position. The data is sent piece by piece, whose size is
+ * the LOB chunk size. Thus the memory usage doesn't depend on the
+ * size of data. +io+ is any object which has <tt>read(length, outbuf)</tt>.
+ * Data read from +io+ for a CLOB must be encoded in OCI8.encoding.
+ * A multibyte character split between reads is sent in one piece.
+ *
+ * When an exception is raised by +io+ or OCI, the unfinished write
+ * is canceled before the exception is passed through.
+ *
+ * It returns the number of written characters (CLOB and NCLOB) or
+ * bytes (BLOB).
+ *
+ * example:
+ *   File.open('large_file.bin', 'rb') do |f|
+ *     blob.write_stream(f)
+ *   end
+ */
+static VALUE oci8_lob_write_stream(VALUE self, VALUE io)
+{
+    oci8_lob_t *lob = DATA_PTR(self);
+    write_stream_arg_t arg;
+    int state = 0;
+
+    lob_open(lob);
+    arg.lob = lob;
+    arg.svcctx = oci8_get_svcctx(lob->svc);
+    arg.io = io;
+    arg.piece_size = UINT2NUM(lob_piece_size(lob, (ub4)-1)); /* streams are usually large. */
+    arg.bufs[0] = rb_str_new(NULL, 0);
+    arg.bufs[1] = rb_str_new(NULL, 0);
+    arg.cur = Qnil;
+    arg.next = Qnil;
+    arg.amt = 0;
+    arg.in_piecewise = 0;
+    rb_protect(write_stream_body, (VALUE)&arg, &state);
+    if (state != 0) {
+        if (arg.in_piecewise) {
+            /* end the piecewise operation not to break later calls. */
+            OCIBreak(arg.svcctx->base.hp.ptr, oci8_errhp);
+            if (have_OCIReset)
+                OCIReset(arg.svcctx->base.hp.ptr, oci8_errhp);
+        }
+        rb_jump_tag(state);
+    }
+    lob->pos += arg.amt;
+    lob_update_length(lob);
+    return UINT2NUM(arg.amt);
+}
+
+/*
+ * call-seq:
+ *   lob << obj -> lob
+ *
+ * Writes +obj+ to the LOB. When +obj+ responds to +read+, it is
+ * streamed by OCI8::LOB#write_stream. Otherwise it is written by
+ * OCI8::LOB#write.
+ *
+ * example:
+ *   clob << 'header' << File.open('body.txt')
+ */
+static VALUE oci8_lob_append(VALUE self, VALUE obj)
+{
+    if (TYPE(obj) != T_STRING && rb_respond_to(obj, id_read)) {
+        oci8_lob_write_stream(self, obj);
+    } else {
+        oci8_lob_write(self, obj);
+    }
+    return self;
+}
+
 static VALUE oci8_lob_get_sync(VALUE self)
 {
     oci8_lob_t *lob = DATA_PTR(self);
@@ -536,6 +878,7 @@ static void oci8_bfile_set_name(VALUE self, VALUE dir_alias, VALUE filename)
     oci8_lob_t *lob = DATA_PTR(self);
 
     bfile_close(lob);
+    lob->length_is_cached = 0;
     if (RSTRING_LEN(dir_alias) > UB2MAXVAL) {
         rb_raise(rb_eRuntimeError, "dir_alias is too long.");
     }
@@ -561,6 +904,8 @@ static VALUE oci8_bfile_initialize(int argc, VALUE *argv, VALUE self)
     lob->svc = svc;
     lob->pos = 0;
     lob->char_width = 1;
+    lob->chunk_size = 0;
+    lob->length_is_cached = 0;
     lob->csfrm = SQLCS_IMPLICIT;
     lob->lobtype = OCI_TEMP_BLOB;
     lob->state = S_BFILE_CLOSE;
@@ -638,6 +983,8 @@ typedef struct {
 static VALUE bind_lob_get(oci8_bind_t *obind, void *data, void *null_struct)
 {
     oci8_hp_obj_t *oho = (oci8_hp_obj_t *)data;
+    /* The locator may have been rewritten by a fetch or an OUT bind. */
+    ((oci8_lob_t *)DATA_PTR(oho->obj))->length_is_cached = 0;
     return oci8_lob_clone(oho->obj);
 }
 
@@ -649,6 +996,7 @@ static void bind_lob_set(oci8_bind_t *obind, void *data, void **null_structp, VA
     if (!rb_obj_is_kind_of(val, *klass->klass))
         rb_raise(rb_eArgError, "Invalid argument: %s (expect %s)", rb_class2name(CLASS_OF(val)), rb_class2name(*klass->klass));
     h = DATA_PTR(val);
+    ((oci8_lob_t *)h)->length_is_cached = 0;
     oho->hp = h->hp.ptr;
     oho->obj = val;
 }
@@ -752,6 +1100,7 @@ static const oci8_bind_lob_class_t bind_bfile_class = {
 void Init_oci8_lob(VALUE cOCI8)
 {
     id_plus = rb_intern("+");
+    id_read = rb_intern("read");
     id_dir_alias = rb_intern("@dir_alias");
     id_filename = rb_intern("@filename");
     seek_set = rb_eval_string("::IO::SEEK_SET");
@@ -779,6 +1128,8 @@ void Init_oci8_lob(VALUE cOCI8)
     rb_define_method(cOCI8LOB, "size=", oci8_lob_set_size, 1);
     rb_define_method(cOCI8LOB, "read", oci8_lob_read, -1);
     rb_define_method(cOCI8LOB, "write", oci8_lob_write, 1);
+    rb_define_method(cOCI8LOB, "write_stream", oci8_lob_write_stream, 1);
+    rb_define_method(cOCI8LOB, "<<", oci8_lob_append, 1);
     rb_define_method(cOCI8LOB, "close", oci8_lob_close, 0);
     rb_define_method(cOCI8LOB, "sync", oci8_lob_get_sync, 0);
     rb_define_method(cOCI8LOB, "sync=", oci8_lob_set_sync, 1);
@@ -794,6 +1145,8 @@ void Init_oci8_lob(VALUE cOCI8)
     rb_define_method(cOCI8BFILE, "truncate", oci8_bfile_error, 1);
     rb_define_method(cOCI8BFILE, "size=", oci8_bfile_error, 1);
     rb_define_method(cOCI8BFILE, "write", oci8_bfile_error, 1);
+    rb_define_method(cOCI8BFILE, "write_stream", oci8_bfile_error, 1);
+    rb_define_method(cOCI8BFILE, "<<", oci8_bfile_error, 1);
 
     oci8_define_bind_class("CLOB", &bind_clob_class.bind);
     oci8_define_bind_class("NCLOB", &bind_nclob_class.bind);
@@ -160,9 +160,8 @@ static VALUE get_attribute(VALUE self, VALUE datatype, VALUE typeinfo, void *dat
     Check_Type(datatype, T_FIXNUM);
     switch (FIX2INT(datatype)) {
     case ATTR_STRING:
-        return rb_external_str_new_with_enc(TO_CHARPTR(OCIStringPtr(oci8_envhp, *(OCIString **)data)),
-                                            OCIStringSize(oci8_envhp, *(OCIString **)data),
-                                            oci8_encoding);
+        return oci8_make_string(TO_CHARPTR(OCIStringPtr(oci8_envhp, *(OCIString **)data)),
+                                OCIStringSize(oci8_envhp, *(OCIString **)data));
     case ATTR_RAW:
         return rb_str_new(TO_CHARPTR(OCIRawPtr(oci8_envhp, *(OCIRaw **)data)),
                           OCIRawSize(oci8_envhp, *(OCIRaw **)data));
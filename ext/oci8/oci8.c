@@ -132,6 +132,7 @@ static VALUE oracle_client_vernum; /* Oracle client version number */
 static VALUE sym_SYSDBA;
 static VALUE sym_SYSOPER;
 static ID id_at_prefetch_rows;
+static ID id_at_statement_cache;
 static ID id_set_prefetch_rows;
 
 static VALUE oci8_s_oracle_client_vernum(VALUE klass)
@@ -528,6 +529,8 @@ static VALUE oci8_svcctx_logoff(VALUE self)
     while (svcctx->base.children != NULL) {
         oci8_base_free(svcctx->base.children);
     }
+    /* cursors in the statement cache were freed above. */
+    rb_ivar_set(self, id_at_statement_cache, rb_hash_new());
     if (svcctx->logoff_strategy != NULL) {
         const oci8_logoff_strategy_t *strategy = svcctx->logoff_strategy;
         void *data = strategy->prepare(svcctx);
@@ -1122,6 +1125,7 @@ VALUE Init_oci8(void)
     sym_SYSDBA = ID2SYM(rb_intern("SYSDBA"));
     sym_SYSOPER = ID2SYM(rb_intern("SYSOPER"));
     id_at_prefetch_rows = rb_intern("@prefetch_rows");
+    id_at_statement_cache = rb_intern("@statement_cache");
     id_set_prefetch_rows = rb_intern("prefetch_rows=");
 
     rb_define_const(cOCI8, "VERSION", rb_obj_freeze(rb_usascii_str_new_cstr(OCI8LIB_VERSION)));
@@ -144,6 +144,7 @@ typedef VALUE rb_blocking_function_t(void *);
 #define rb_str_export_to_enc(str, enc) (str)
 #define rb_usascii_str_new(ptr, len) rb_str_new((ptr), (len))
 #define rb_usascii_str_new_cstr(ptr) rb_str_new2(ptr)
+#define oci8_make_string(ptr, len) rb_tainted_str_new((ptr), (len))
 #endif
 
 /* a new function in ruby 1.9.3.
@@ -293,6 +294,8 @@ struct oci8_bind {
     ub4 maxar_sz; /* maximum array size. */
     ub4 curar_sz; /* current array size. */
     ub4 curar_idx;/* current array index. */
+    char builtin_get; /* true when 'get' isn't overridden in ruby. */
+    char builtin_set; /* true when 'set' isn't overridden in ruby. */
     VALUE tdo;
     union {
         void **null_structs;
@@ -470,6 +473,12 @@ void Init_oci8_bind(VALUE cOCI8BindTypeBase);
 oci8_bind_t *oci8_get_bind(VALUE obj);
 void oci8_bind_set_data(VALUE self, VALUE val);
 VALUE oci8_bind_get_data(VALUE self);
+VALUE oci8_bind_get_elem(VALUE self, ub4 idx);
+int oci8_bind_is_null(const oci8_bind_t *obind, ub4 idx);
+VALUE oci8_bind_string_dedup_stats(oci8_bind_t *obind);
+int oci8_bind_string_is_dynamic(const oci8_bind_t *obind);
+sword oci8_bind_string_define_dynamic(oci8_bind_t *obind);
+size_t oci8_bind_bytes_allocated(const oci8_bind_t *obind);
 
 /* metadata.c */
 extern VALUE cOCI8MetadataBase;
@@ -501,6 +510,7 @@ OCINumber *oci8_set_ocinumber(OCINumber *result, VALUE self, OCIError *errhp);
 OCINumber *oci8_set_integer(OCINumber *result, VALUE self, OCIError *errhp);
 double oci8_onum_to_dbl(OCINumber *s, OCIError *errhp);
 OCINumber *oci8_dbl_to_onum(OCINumber *result, double dbl, OCIError *errhp);
+int oci8_number_bind_pack_type(const oci8_bind_t *obind);
 
 /* ocidatetim.c */
 void Init_oci_datetime(void);
@@ -533,6 +543,8 @@ void Init_oci8_win32(VALUE cOCI8);
 #ifdef HAVE_TYPE_RB_ENCODING
 extern rb_encoding *oci8_encoding;
 
+VALUE oci8_make_string(const char *ptr, long len);
+
 #define OCI8StringValue(v) do { \
     StringValue(v); \
     (v) = rb_str_export_to_enc(v, oci8_encoding); \
@@ -9,6 +9,11 @@
  *
  */
 #include "oci8.h"
+#include <time.h>
+
+static ID id_local;
+static ID id_localtime;
+static ID id_utc;
 
 VALUE oci8_make_ocidate(OCIDate *od)
 {
@@ -266,6 +271,400 @@ static const oci8_bind_class_t bind_ocitimestamp_tz_class = {
     SQLT_TIMESTAMP_TZ
 };
 
+#if defined(HAVE_RB_TIME_TIMESPEC_NEW) || defined(HAVE_RB_TIME_NANO_NEW)
+/*
+ * bind_ocitimestamp_tz_as_time
+ */
+typedef struct {
+    oci8_bind_t obind;
+    /* UTC offset of local time cached by wall-clock hour, which is
+     * used only by raw timestamps without time zone. */
+    int has_local_offset;
+    time_t local_hour;
+    long local_offset;
+} oci8_bind_time_t;
+
+/* the time zone of Time objects made by make_time() */
+enum {
+    TIME_ZONE_FIXED,
+    TIME_ZONE_LOCAL,
+    TIME_ZONE_UTC
+};
+
+/* days since 1970-01-01 in the proleptic Gregorian calendar */
+static long days_from_civil(long year, int month, int day)
+{
+    long era;
+    long yoe;
+    long doy;
+
+    if (month <= 2) {
+        year--;
+    }
+    era = (year >= 0 ? year : year - 399) / 400;
+    yoe = year - era * 400;
+    doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
+/* the inverse of days_from_civil() */
+static void civil_from_days(long days, long *year, int *month, int *day)
+{
+    long era;
+    long doe;
+    long yoe;
+    long doy;
+    long mp;
+
+    days += 719468;
+    era = (days >= 0 ? days : days - 146096) / 146097;
+    doe = days - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    *day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *year = yoe + era * 400 + (*month <= 2);
+}
+
+/*
+ * Gets the UTC offset of local time at +wall+, the seconds since
+ * the epoch of a wall-clock time. Returns zero when it is out of
+ * the range of mktime().
+ */
+static int local_utc_offset(oci8_bind_time_t *obt, time_t wall, long *offset)
+{
+    time_t hour = (wall >= 0 ? wall : wall - 3599) / 3600;
+    struct tm tm;
+    time_t t;
+    long days;
+
+    if (obt->has_local_offset && obt->local_hour == hour) {
+        *offset = obt->local_offset;
+        return 1;
+    }
+    days = (long)((hour >= 0 ? hour : hour - 23) / 24);
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_year = 70;
+    tm.tm_mday = 1 + days;
+    tm.tm_hour = (int)(hour - (time_t)days * 24);
+    tm.tm_isdst = -1;
+    t = mktime(&tm);
+    if (t == (time_t)-1) {
+        return 0;
+    }
+    obt->has_local_offset = 1;
+    obt->local_hour = hour;
+    obt->local_offset = (long)(hour * 3600 - t);
+    *offset = obt->local_offset;
+    return 1;
+}
+
+/*
+ * Makes a Time from +wall+, the seconds since the epoch of a
+ * wall-clock time, and +fsec+ in nanoseconds. +offset+ is used
+ * only when +zone+ is TIME_ZONE_FIXED.
+ */
+static VALUE make_time(oci8_bind_time_t *obt, time_t wall, ub4 fsec, int zone, long offset)
+{
+#ifdef HAVE_RB_TIME_TIMESPEC_NEW
+    struct timespec ts;
+#else
+    VALUE tm;
+#endif
+
+    switch (zone) {
+    case TIME_ZONE_LOCAL:
+        if (!local_utc_offset(obt, wall, &offset)) {
+            time_t secs = wall % 86400;
+            long year;
+            int month;
+            int day;
+
+            if (secs < 0) {
+                secs += 86400;
+            }
+            civil_from_days((long)((wall - secs) / 86400), &year, &month, &day);
+            return rb_funcall(rb_cTime, id_local, 7, LONG2NUM(year), INT2FIX(month), INT2FIX(day),
+                              INT2FIX(secs / 3600), INT2FIX(secs / 60 % 60), INT2FIX(secs % 60),
+                              INT2FIX(fsec / 1000));
+        }
+        break;
+    case TIME_ZONE_UTC:
+        offset = 0;
+        break;
+    }
+#ifdef HAVE_RB_TIME_TIMESPEC_NEW
+    ts.tv_sec = wall - offset;
+    ts.tv_nsec = fsec;
+    switch (zone) {
+    case TIME_ZONE_LOCAL:
+        return rb_time_timespec_new(&ts, INT_MAX);
+    case TIME_ZONE_UTC:
+        return rb_time_timespec_new(&ts, INT_MAX - 1);
+    }
+    return rb_time_timespec_new(&ts, (int)offset);
+#else
+    tm = rb_time_nano_new(wall - offset, fsec);
+    switch (zone) {
+    case TIME_ZONE_LOCAL:
+        return rb_funcall(tm, id_localtime, 0);
+    case TIME_ZONE_UTC:
+        return rb_funcall(tm, id_utc, 0);
+    }
+    return rb_funcall(tm, id_localtime, 1, LONG2FIX(offset));
+#endif
+}
+
+static VALUE bind_ocitimestamp_tz_as_time_get(oci8_bind_t *obind, void *data, void *null_struct)
+{
+    OCIDateTime *dttm = *(OCIDateTime **)data;
+    sb2 year;
+    ub1 month;
+    ub1 day;
+    ub1 hour;
+    ub1 minute;
+    ub1 sec;
+    ub4 fsec;
+    sb1 tz_hour;
+    sb1 tz_minute;
+    time_t wall;
+
+    oci_lc(OCIDateTimeGetDate(oci8_envhp, oci8_errhp, dttm, &year, &month, &day));
+    oci_lc(OCIDateTimeGetTime(oci8_envhp, oci8_errhp, dttm, &hour, &minute, &sec, &fsec));
+    /* values defined as SQLT_TIMESTAMP_TZ always have a time zone offset. */
+    oci_lc(OCIDateTimeGetTimeZoneOffset(oci8_envhp, oci8_errhp, dttm, &tz_hour, &tz_minute));
+    wall = (time_t)days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + sec;
+    return make_time((oci8_bind_time_t *)obind, wall, fsec, TIME_ZONE_FIXED, tz_hour * 3600 + tz_minute * 60);
+}
+
+static const oci8_bind_class_t bind_ocitimestamp_tz_as_time_class = {
+    {
+        NULL,
+        bind_ocitimestamp_tz_free,
+        sizeof(oci8_bind_time_t)
+    },
+    bind_ocitimestamp_tz_as_time_get,
+    bind_ocitimestamp_tz_set,
+    bind_ocitimestamp_tz_init,
+    bind_ocitimestamp_tz_init_elem,
+    NULL,
+    SQLT_TIMESTAMP_TZ
+};
+
+/*
+ * bind_raw_timestamp and bind_raw_timestamp_tz
+ *
+ * TIMESTAMP and TIMESTAMP WITH TIME ZONE in Oracle's internal
+ * format, which are defined without OCIDateTime descriptors.
+ *
+ *   byte 0-6:  the same with DATE: century + 100, year + 100, month,
+ *              day, hour + 1, minute + 1 and second + 1.
+ *   byte 7-10: fractional second in nanoseconds (big endian)
+ *   byte 11:   time zone hour + 20 (TIMESTAMP WITH TIME ZONE only)
+ *   byte 12:   time zone minute + 60 (TIMESTAMP WITH TIME ZONE only)
+ *
+ * The date and time of TIMESTAMP WITH TIME ZONE are in UTC. When
+ * the highest bit of byte 11 is set, the time zone is a region ID.
+ */
+#define DTY_RAW_TIMESTAMP 180
+#define DTY_RAW_TIMESTAMP_TZ 181
+#define RAW_TIMESTAMP_SIZE 11
+#define RAW_TIMESTAMP_TZ_SIZE 13
+
+static time_t raw_timestamp_to_wall(const ub1 *p, ub4 *fsec)
+{
+    long year = (p[0] - 100) * 100 + (p[1] - 100);
+
+    *fsec = ((ub4)p[7] << 24) | ((ub4)p[8] << 16) | ((ub4)p[9] << 8) | p[10];
+    return (time_t)days_from_civil(year, p[2], p[3]) * 86400 + (p[4] - 1) * 3600 + (p[5] - 1) * 60 + (p[6] - 1);
+}
+
+static void wall_to_raw_timestamp(ub1 *p, time_t wall, ub4 fsec)
+{
+    time_t secs = wall % 86400;
+    long year;
+    int month;
+    int day;
+
+    if (secs < 0) {
+        secs += 86400;
+    }
+    civil_from_days((long)((wall - secs) / 86400), &year, &month, &day);
+    if (year < -4712 || 9999 < year) {
+        rb_raise(rb_eRuntimeError, "out of year range: %ld", year);
+    }
+    p[0] = (ub1)(year / 100 + 100);
+    p[1] = (ub1)(year % 100 + 100);
+    p[2] = (ub1)month;
+    p[3] = (ub1)day;
+    p[4] = (ub1)(secs / 3600 + 1);
+    p[5] = (ub1)(secs / 60 % 60 + 1);
+    p[6] = (ub1)(secs % 60 + 1);
+    p[7] = (ub1)(fsec >> 24);
+    p[8] = (ub1)(fsec >> 16);
+    p[9] = (ub1)(fsec >> 8);
+    p[10] = (ub1)fsec;
+}
+
+/*
+ * Converts an array made by OCI8::BindType::Util#datetime_to_array to
+ * a wall-clock time.
+ */
+static time_t array_to_wall(VALUE val, ub4 *fsec, int *has_tz, long *offset)
+{
+    long year;
+    long month;
+    long day;
+    long hour;
+    long minute;
+    long sec;
+
+    Check_Type(val, T_ARRAY);
+    if (RARRAY_LEN(val) != 9) {
+        rb_raise(rb_eRuntimeError, "invalid array size %ld", RARRAY_LEN(val));
+    }
+    year = NUM2LONG(RARRAY_PTR(val)[0]);
+    month = NUM2LONG(RARRAY_PTR(val)[1]);
+    if (month < 1 || 12 < month) {
+        rb_raise(rb_eRuntimeError, "out of month range: %ld", month);
+    }
+    day = NUM2LONG(RARRAY_PTR(val)[2]);
+    if (day < 1 || 31 < day) {
+        rb_raise(rb_eRuntimeError, "out of day range: %ld", day);
+    }
+    hour = NUM2LONG(RARRAY_PTR(val)[3]);
+    minute = NUM2LONG(RARRAY_PTR(val)[4]);
+    sec = NUM2LONG(RARRAY_PTR(val)[5]);
+    *fsec = NUM2ULONG(RARRAY_PTR(val)[6]);
+    if (*fsec >= 1000000000) {
+        rb_raise(rb_eRuntimeError, "out of sec_fraction range: %u", *fsec);
+    }
+    if (NIL_P(RARRAY_PTR(val)[7]) && NIL_P(RARRAY_PTR(val)[8])) {
+        *has_tz = 0;
+    } else {
+        *has_tz = 1;
+        *offset = NUM2LONG(RARRAY_PTR(val)[7]) * 3600 + NUM2LONG(RARRAY_PTR(val)[8]) * 60;
+    }
+    return (time_t)days_from_civil(year, (int)month, (int)day) * 86400 + hour * 3600 + minute * 60 + sec;
+}
+
+static VALUE bind_raw_timestamp_get(oci8_bind_t *obind, void *data, void *null_struct)
+{
+    ub4 fsec;
+    time_t wall = raw_timestamp_to_wall((const ub1 *)data, &fsec);
+
+    return make_time((oci8_bind_time_t *)obind, wall, fsec, TIME_ZONE_LOCAL, 0);
+}
+
+static void bind_raw_timestamp_set(oci8_bind_t *obind, void *data, void **null_structp, VALUE val)
+{
+    oci8_bind_time_t *obt = (oci8_bind_time_t *)obind;
+    ub4 fsec;
+    int has_tz;
+    long offset;
+    long local_offset;
+    time_t wall = array_to_wall(val, &fsec, &has_tz, &offset);
+
+    if (has_tz) {
+        /* convert to local time. The offset is looked up again
+         * when the first guess crosses a DST transition. */
+        time_t utc = wall - offset;
+
+        if (local_utc_offset(obt, utc, &local_offset)) {
+            wall = utc + local_offset;
+            if (local_utc_offset(obt, wall, &offset)) {
+                wall = utc + offset;
+            }
+        }
+    }
+    wall_to_raw_timestamp((ub1 *)data, wall, fsec);
+}
+
+static void bind_raw_timestamp_init(oci8_bind_t *obind, VALUE svc, VALUE val, VALUE length)
+{
+    obind->value_sz = RAW_TIMESTAMP_SIZE;
+    obind->alloc_sz = RAW_TIMESTAMP_SIZE;
+}
+
+/*
+ * Clears fractional seconds. TIMESTAMP values without fractional
+ * seconds may be fetched as seven bytes.
+ */
+static void bind_raw_timestamp_pre_fetch_hook(oci8_bind_t *obind, VALUE svc)
+{
+    memset(obind->valuep, 0, obind->alloc_sz * (obind->maxar_sz ? obind->maxar_sz : 1));
+}
+
+static VALUE bind_raw_timestamp_tz_get(oci8_bind_t *obind, void *data, void *null_struct)
+{
+    const ub1 *p = (const ub1 *)data;
+    ub4 fsec;
+    time_t wall = raw_timestamp_to_wall(p, &fsec);
+    long offset;
+
+    if (p[11] & 0x80) {
+        /* The time zone is a region ID. */
+        return make_time((oci8_bind_time_t *)obind, wall, fsec, TIME_ZONE_UTC, 0);
+    }
+    offset = (p[11] - 20) * 3600 + (p[12] - 60) * 60;
+    return make_time((oci8_bind_time_t *)obind, wall + offset, fsec, TIME_ZONE_FIXED, offset);
+}
+
+static void bind_raw_timestamp_tz_set(oci8_bind_t *obind, void *data, void **null_structp, VALUE val)
+{
+    ub1 *p = (ub1 *)data;
+    ub4 fsec;
+    int has_tz;
+    long offset;
+    time_t wall = array_to_wall(val, &fsec, &has_tz, &offset);
+
+    if (!has_tz && !local_utc_offset((oci8_bind_time_t *)obind, wall, &offset)) {
+        offset = 0;
+    }
+    if (offset % 60 != 0 || offset < -12 * 3600 || 14 * 3600 < offset) {
+        rb_raise(rb_eRuntimeError, "out of time zone range: %ld seconds", offset);
+    }
+    wall_to_raw_timestamp(p, wall - offset, fsec);
+    p[11] = (ub1)(offset / 3600 + 20);
+    p[12] = (ub1)(offset % 3600 / 60 + 60);
+}
+
+static void bind_raw_timestamp_tz_init(oci8_bind_t *obind, VALUE svc, VALUE val, VALUE length)
+{
+    obind->value_sz = RAW_TIMESTAMP_TZ_SIZE;
+    obind->alloc_sz = RAW_TIMESTAMP_TZ_SIZE;
+}
+
+static const oci8_bind_class_t bind_raw_timestamp_class = {
+    {
+        NULL,
+        oci8_bind_free,
+        sizeof(oci8_bind_time_t)
+    },
+    bind_raw_timestamp_get,
+    bind_raw_timestamp_set,
+    bind_raw_timestamp_init,
+    NULL,
+    bind_raw_timestamp_pre_fetch_hook,
+    DTY_RAW_TIMESTAMP
+};
+
+static const oci8_bind_class_t bind_raw_timestamp_tz_class = {
+    {
+        NULL,
+        oci8_bind_free,
+        sizeof(oci8_bind_time_t)
+    },
+    bind_raw_timestamp_tz_get,
+    bind_raw_timestamp_tz_set,
+    bind_raw_timestamp_tz_init,
+    NULL,
+    NULL,
+    DTY_RAW_TIMESTAMP_TZ
+};
+#endif
+
 VALUE oci8_make_ociinterval_ym(OCIInterval *s)
 {
     sb4 year;
@@ -453,7 +852,16 @@ static const oci8_bind_class_t bind_ociinterval_ds_class = {
 
 void Init_oci_datetime(void)
 {
+    id_local = rb_intern("local");
+    id_localtime = rb_intern("localtime");
+    id_utc = rb_intern("utc");
+
     oci8_define_bind_class("OCITimestampTZ", &bind_ocitimestamp_tz_class);
+#if defined(HAVE_RB_TIME_TIMESPEC_NEW) || defined(HAVE_RB_TIME_NANO_NEW)
+    oci8_define_bind_class("OCITimestampTZAsTime", &bind_ocitimestamp_tz_as_time_class);
+    oci8_define_bind_class("OCIRawTimestamp", &bind_raw_timestamp_class);
+    oci8_define_bind_class("OCIRawTimestampTZ", &bind_raw_timestamp_tz_class);
+#endif
     oci8_define_bind_class("OCIIntervalYM", &bind_ociinterval_ym_class);
     oci8_define_bind_class("OCIIntervalDS", &bind_ociinterval_ds_class);
 }
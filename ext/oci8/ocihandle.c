@@ -328,7 +328,7 @@ static VALUE attr_get_string(VALUE self, VALUE attr_type)
     v.dummy = MAGIC_NUMBER;
     Check_Type(attr_type, T_FIXNUM);
     oci_lc(OCIAttrGet(base->hp.ptr, base->type, &v.value, &size, FIX2INT(attr_type), oci8_errhp));
-    return rb_external_str_new_with_enc(v.value, size, oci8_encoding);
+    return oci8_make_string(v.value, size);
 }
 
 /*
@@ -27,6 +27,7 @@ static ID id_power; /* rb_intern("**") */
 static ID id_cmp;   /* rb_intern("<=>") */
 static ID id_finite_p;
 static ID id_split;
+static ID id_to_s;
 static ID id_numerator;
 static ID id_denominator;
 static ID id_Rational;
@@ -112,25 +113,242 @@ static VALUE onum_s_alloc(VALUE klass)
     return obj;
 }
 
-/* construct an ruby object(OCI::Number) from C structure (OCINumber). */
-VALUE oci8_make_ocinumber(OCINumber *s, OCIError *errhp)
+static VALUE make_ocinumber(const OCINumber *s)
 {
     VALUE obj;
     OCINumber *d;
 
     obj = Data_Make_Struct(cOCINumber, OCINumber, NULL, xfree, d);
-    oci_lc(OCINumberAssign(errhp, s, d));
+    *d = *s;
     return obj;
 }
 
+/* construct an ruby object(OCI::Number) from C structure (OCINumber). */
+VALUE oci8_make_ocinumber(OCINumber *s, OCIError *errhp)
+{
+    return make_ocinumber(s);
+}
+
+#ifdef HAVE_RB_INTEGER_PACK
+/* The integer part of OCINumber is less than 10^126 < 2^419. */
+#define ORANUMBER_INT_WORDS 14
+
+/* words = words * mul + add */
+static void int_words_mul_add(ub4 *words, int *nwords, ub4 mul, ub4 add)
+{
+    oranumber_uint64 carry = add;
+    int i;
+
+    for (i = 0; i < *nwords; i++) {
+        carry += (oranumber_uint64)words[i] * mul;
+        words[i] = (ub4)carry;
+        carry >>= 32;
+    }
+    if (carry != 0) {
+        words[(*nwords)++] = (ub4)carry;
+    }
+}
+
+/*
+ * Converts the integer part of an OCINumber which doesn't fit in
+ * 64 bits to an Integer. The base-100 mantissa is accumulated into
+ * 32-bit words and unpacked to a Bignum without intermediate objects.
+ * It returns nil for infinity and broken internal formats.
+ */
+static VALUE oranumber_to_bignum(const OCINumber *on)
+{
+    static const ub4 pow100[] = {1, 100, 10000, 1000000, 100000000};
+    int datalen = on->OCINumberPart[0];
+    const ub1 *mantissa = on->OCINumberPart + 2;
+    int is_positive;
+    int exponent;
+    int idx;
+    int n;
+    int chunk_digits = 0;
+    ub4 chunk = 0;
+    ub4 words[ORANUMBER_INT_WORDS];
+    int nwords = 0;
+
+    if (datalen < 2 || datalen > 21) {
+        return Qnil;
+    }
+    if (datalen == 2 && on->OCINumberPart[1] == 255 && on->OCINumberPart[2] == 101) {
+        /* positive infinity */
+        return Qnil;
+    }
+    datalen--; /* number of base-100 digits */
+    if (on->OCINumberPart[1] >= 128) {
+        is_positive = 1;
+        exponent = on->OCINumberPart[1] - 193;
+    } else {
+        is_positive = 0;
+        exponent = 62 - on->OCINumberPart[1];
+        if (mantissa[datalen - 1] == 102) {
+            /* negative value's terminator */
+            datalen--;
+        }
+    }
+    if (exponent < 0) {
+        return INT2FIX(0);
+    }
+    if (exponent > 62) {
+        /* broken internal format. This keeps words in bounds. */
+        return Qnil;
+    }
+    /* accumulate four base-100 digits at once. */
+    for (idx = 0; idx <= exponent; idx++) {
+        if (idx < datalen) {
+            n = is_positive ? (mantissa[idx] - 1) : (101 - mantissa[idx]);
+            if (n < 0 || 99 < n) {
+                return Qnil;
+            }
+        } else {
+            /* trailing zeros which are not stored in the mantissa. */
+            n = 0;
+        }
+        chunk = chunk * 100 + n;
+        if (++chunk_digits == 4) {
+            int_words_mul_add(words, &nwords, pow100[4], chunk);
+            chunk = 0;
+            chunk_digits = 0;
+        }
+    }
+    if (chunk_digits > 0) {
+        int_words_mul_add(words, &nwords, pow100[chunk_digits], chunk);
+    }
+    return rb_integer_unpack(words, nwords, sizeof(ub4), 0,
+                             INTEGER_PACK_LSWORD_FIRST | INTEGER_PACK_NATIVE_BYTE_ORDER |
+                             (is_positive ? 0 : INTEGER_PACK_NEGATIVE));
+}
+
+/* Converts a Bignum to OCINumber by dividing its words by 10^9. */
+static int oranumber_from_bignum(OCINumber *on, VALUE num)
+{
+    ub4 words[ORANUMBER_INT_WORDS];
+    char digits[ORANUMBER_INT_WORDS * 10]; /* from the least significant digit */
+    char mantissa[41];
+    int nwords = ORANUMBER_INT_WORDS;
+    int ndigits = 0;
+    int sign;
+    int i;
+
+    if (rb_absint_size(num, NULL) > sizeof(words)) {
+        return ORANUMBER_NUMERIC_OVERFLOW;
+    }
+    sign = rb_integer_pack(num, words, ORANUMBER_INT_WORDS, sizeof(ub4), 0,
+                           INTEGER_PACK_LSWORD_FIRST | INTEGER_PACK_NATIVE_BYTE_ORDER);
+    while (nwords > 0 && words[nwords - 1] == 0) {
+        nwords--;
+    }
+    while (nwords > 0) {
+        oranumber_uint64 rem = 0;
+
+        for (i = nwords - 1; i >= 0; i--) {
+            rem = (rem << 32) | words[i];
+            words[i] = (ub4)(rem / 1000000000);
+            rem %= 1000000000;
+        }
+        while (nwords > 0 && words[nwords - 1] == 0) {
+            nwords--;
+        }
+        for (i = 0; i < 9; i++) {
+            digits[ndigits++] = (char)(rem % 10);
+            rem /= 10;
+        }
+    }
+    while (ndigits > 0 && digits[ndigits - 1] == 0) {
+        ndigits--;
+    }
+    for (i = 0; i < ndigits && i < 41; i++) {
+        mantissa[i] = digits[ndigits - 1 - i];
+    }
+    return oranumber_from_mantissa(on, sign >= 0, mantissa, ndigits, ndigits - 1);
+}
+#else
+/*
+ * Converts the integer part of an OCINumber which doesn't fit in
+ * 64 bits to an Integer. The base-100 mantissa is packed into
+ * chunks of nine digits (10^18) to reduce Bignum operations.
+ * It returns nil for infinity and broken internal formats.
+ */
+static VALUE oranumber_to_bignum(const OCINumber *on)
+{
+    int datalen = on->OCINumberPart[0];
+    const ub1 *mantissa = on->OCINumberPart + 2;
+    int is_positive;
+    int exponent;
+    int idx;
+    int n;
+    int chunk_digits = 0;
+    oranumber_int64 chunk = 0;
+    VALUE val = INT2FIX(0);
+
+    if (datalen < 2 || datalen > 21) {
+        return Qnil;
+    }
+    if (datalen == 2 && on->OCINumberPart[1] == 255 && on->OCINumberPart[2] == 101) {
+        /* positive infinity */
+        return Qnil;
+    }
+    datalen--; /* number of base-100 digits */
+    if (on->OCINumberPart[1] >= 128) {
+        is_positive = 1;
+        exponent = on->OCINumberPart[1] - 193;
+    } else {
+        is_positive = 0;
+        exponent = 62 - on->OCINumberPart[1];
+        if (mantissa[datalen - 1] == 102) {
+            /* negative value's terminator */
+            datalen--;
+        }
+    }
+    if (exponent < 0) {
+        return INT2FIX(0);
+    }
+    for (idx = 0; idx <= exponent && idx < datalen; idx++) {
+        n = is_positive ? (mantissa[idx] - 1) : (101 - mantissa[idx]);
+        if (n < 0 || 99 < n) {
+            return Qnil;
+        }
+        chunk = chunk * 100 + n;
+        if (++chunk_digits == 9) {
+            val = rb_funcall(val, '*', 1, LL2NUM((oranumber_int64)1000000000 * 1000000000));
+            val = rb_funcall(val, '+', 1, LL2NUM(chunk));
+            chunk = 0;
+            chunk_digits = 0;
+        }
+    }
+    if (chunk_digits > 0) {
+        val = rb_funcall(val, '*', 1, rb_funcall(INT2FIX(100), id_power, 1, INT2FIX(chunk_digits)));
+        val = rb_funcall(val, '+', 1, LL2NUM(chunk));
+    }
+    if (idx <= exponent) {
+        /* trailing zeros which are not stored in the mantissa. */
+        val = rb_funcall(val, '*', 1, rb_funcall(INT2FIX(100), id_power, 1, INT2FIX(exponent - idx + 1)));
+    }
+    if (!is_positive) {
+        val = rb_funcall(INT2FIX(0), '-', 1, val);
+    }
+    return val;
+}
+#endif
+
 VALUE oci8_make_integer(OCINumber *s, OCIError *errhp)
 {
-    signed long sl;
+    oranumber_int64 ll;
     char buf[512];
     sword rv;
+    VALUE val;
 
-    if (OCINumberToInt(errhp, s, sizeof(sl), OCI_NUMBER_SIGNED, &sl) == OCI_SUCCESS) {
-        return LONG2NUM(sl);
+    switch (oranumber_to_int64(s, &ll)) {
+    case ORANUMBER_SUCCESS:
+        return LL2NUM(ll);
+    case ORANUMBER_NUMERIC_OVERFLOW:
+        val = oranumber_to_bignum(s);
+        if (!NIL_P(val)) {
+            return val;
+        }
+        break;
     }
     /* convert to Integer via String */
     rv = oranumber_to_str(s, buf, sizeof(buf));
@@ -194,7 +412,7 @@ static void set_oci_number_from_str(OCINumber *result, VALUE str, VALUE fmt, VAL
 /* 1 - success, 0 - error */
 static int set_oci_number_from_num(OCINumber *result, VALUE num, int force, OCIError *errhp)
 {
-    signed long sl;
+    int rv;
 
     if (!RTEST(rb_obj_is_kind_of(num, rb_cNumeric)))
         rb_raise(rb_eTypeError, "expect Numeric but %s", rb_class2name(CLASS_OF(num)));
@@ -204,17 +422,23 @@ static int set_oci_number_from_num(OCINumber *result, VALUE num, int force, OCIE
     switch (rb_type(num)) {
     case T_FIXNUM:
         /* set from long. */
-        sl = NUM2LONG(num);
-        oci_lc(OCINumberFromInt(errhp, &sl, sizeof(sl), OCI_NUMBER_SIGNED, result));
+        oranumber_from_int64(result, FIX2LONG(num));
         return 1;
     case T_FLOAT:
         /* set from double. */
         oci8_dbl_to_onum(result, NUM2DBL(num), errhp);
         return 1;
     case T_BIGNUM:
+#ifdef HAVE_RB_INTEGER_PACK
+        rv = oranumber_from_bignum(result, num);
+        if (rv != ORANUMBER_SUCCESS) {
+            oci8_raise_by_msgno(rv, "numeric overflow");
+        }
+#else
         /* change via string. */
         num = rb_big2str(num, 10);
         set_oci_number_from_str(result, num, Qnil, Qnil, errhp);
+#endif
         return 1;
     }
     if (RTEST(rb_obj_is_instance_of(num, cOCINumber))) {
@@ -222,6 +446,20 @@ static int set_oci_number_from_num(OCINumber *result, VALUE num, int force, OCIE
         oci_lc(OCINumberAssign(errhp, DATA_PTR(num), result));
         return 1;
     }
+    if (rboci8_type(num) == RBOCI8_T_BIGDECIMAL) {
+        /* BigDecimal#to_s returns "0.xxxxxEnn", which is parsed directly. */
+        VALUE str = rb_funcall(num, id_to_s, 0);
+
+        if (TYPE(str) == T_STRING) {
+            rv = oranumber_from_str(result, RSTRING_PTR(str), RSTRING_LEN(str));
+            if (rv == ORANUMBER_SUCCESS) {
+                return 1;
+            }
+            if (rv == ORANUMBER_NUMERIC_OVERFLOW) {
+                oci8_raise_by_msgno(rv, "numeric overflow");
+            }
+        }
+    }
     if (rb_respond_to(num, id_split)) {
         /* BigDecimal */
         VALUE split = rb_funcall(num, id_split, 0);
@@ -233,10 +471,12 @@ static int set_oci_number_from_num(OCINumber *result, VALUE num, int force, OCIE
              */
             VALUE *ary = RARRAY_PTR(split);
             int sign;
-            OCINumber digits;
-            int exponent;
-            int digits_len;
-            OCINumber work;
+            long exponent;
+            const char *digits;
+            long digits_len;
+            char mantissa[41];
+            int idx = 0;
+            long i;
 
             /* check sign */
             if (TYPE(ary[0]) != T_FIXNUM) {
@@ -245,8 +485,6 @@ static int set_oci_number_from_num(OCINumber *result, VALUE num, int force, OCIE
             sign = FIX2INT(ary[0]);
             /* check digits */
             StringValue(ary[1]);
-            digits_len = RSTRING_LEN(ary[1]);
-            set_oci_number_from_str(&digits, ary[1], Qnil, Qnil, errhp);
             /* check base */
             if (TYPE(ary[2]) != T_FIXNUM || FIX2LONG(ary[2]) != 10) {
                 goto is_not_big_decimal;
@@ -255,25 +493,27 @@ static int set_oci_number_from_num(OCINumber *result, VALUE num, int force, OCIE
             if (TYPE(ary[3]) != T_FIXNUM) {
                 goto is_not_big_decimal;
             }
-            exponent = FIX2INT(ary[3]);
-
-            if (have_OCINumberShift) {
-                /* Oracle 8.1 or upper */
-                oci_lc(OCINumberShift(errhp, &digits, exponent - digits_len, &work));
-            } else {
-                /* Oracle 8.0 */
-                int n = 10;
-                OCINumber base;
-                OCINumber exp;
-
-                oci_lc(OCINumberFromInt(errhp, &n, sizeof(n), OCI_NUMBER_SIGNED, &base));
-                oci_lc(OCINumberIntPower(errhp, &base, exponent - digits_len, &exp));
-                oci_lc(OCINumberMul(errhp, &digits, &exp, &work));
+            exponent = FIX2LONG(ary[3]);
+
+            /* put the digits to the mantissa without leading zeros. */
+            digits = RSTRING_PTR(ary[1]);
+            digits_len = RSTRING_LEN(ary[1]);
+            for (i = 0; i < digits_len; i++) {
+                if (digits[i] < '0' || '9' < digits[i]) {
+                    oci8_raise_by_msgno(ORANUMBER_INVALID_NUMBER, "invalid number");
+                }
+                if (idx == 0 && digits[i] == '0') {
+                    exponent--;
+                    continue;
+                }
+                if (idx < 41) {
+                    mantissa[idx] = digits[i] - '0';
+                }
+                idx++;
             }
-            if (sign >= 0) {
-                oci_lc(OCINumberAssign(errhp, &work, result));
-            } else {
-                oci_lc(OCINumberNeg(errhp, &work, result));
+            rv = oranumber_from_mantissa(result, sign >= 0, mantissa, idx, exponent - 1);
+            if (rv != ORANUMBER_SUCCESS) {
+                oci8_raise_by_msgno(rv, "numeric overflow");
             }
             return 1;
         }
@@ -306,6 +546,16 @@ OCINumber *oci8_set_ocinumber(OCINumber *result, VALUE self, OCIError *errhp)
 }
 #define TO_OCINUM oci8_set_ocinumber
 
+/* fill C structure (OCINumber) from an Integer without OCI calls if possible. */
+static void set_oci_number_from_int(OCINumber *result, VALUE num)
+{
+    if (FIXNUM_P(num)) {
+        oranumber_from_int64(result, FIX2LONG(num));
+    } else {
+        set_oci_number_from_num(result, num, 1, oci8_errhp);
+    }
+}
+
 OCINumber *oci8_set_integer(OCINumber *result, VALUE self, OCIError *errhp)
 {
     OCINumber work;
@@ -318,22 +568,16 @@ OCINumber *oci8_set_integer(OCINumber *result, VALUE self, OCIError *errhp)
 double oci8_onum_to_dbl(OCINumber *s, OCIError *errhp)
 {
     if (oci8_float_conversion_type_is_ruby) {
-        char buf[256];
-        sword rv;
+        double dbl;
 
-        rv = oranumber_to_str(s, buf, sizeof(buf));
-        if (rv <= 0) {
+        /* The result is correctly rounded as String#to_f. */
+        if (oranumber_to_double(s, &dbl) != ORANUMBER_SUCCESS) {
             char buf[ORANUMBER_DUMP_BUF_SIZ];
 
             oranumber_dump(s, buf);
             rb_raise(eOCIException, "Invalid internal number format: %s", buf);
         }
-        if (strcmp(buf, "~") == 0) {
-            return INFINITY;
-        } else if (strcmp(buf, "-~") == 0) {
-            return -INFINITY;
-        }
-        return rb_cstr_to_dbl(buf, Qtrue);
+        return dbl;
     } else {
         double dbl;
 
@@ -359,11 +603,10 @@ OCINumber *oci8_dbl_to_onum(OCINumber *result, double dbl, OCIError *errhp)
     }
 
     if (oci8_float_conversion_type_is_ruby) {
-        VALUE str;
         sword rv;
 
-        str = rb_obj_as_string(rb_float_new(dbl));
-        rv = oranumber_from_str(result, RSTRING_PTR(str), RSTRING_LEN(str));
+        /* same digits with Float#to_s */
+        rv = oranumber_from_double(result, dbl);
         if (rv != 0) {
             oci8_raise_by_msgno(rv, NULL);
         }
@@ -720,19 +963,13 @@ static VALUE onum_initialize_copy(VALUE lhs, VALUE rhs)
 
 static VALUE onum_coerce(VALUE self, VALUE other)
 {
-    signed long sl;
     OCINumber n;
 
     switch(rboci8_type(other)) {
     case T_FIXNUM:
-        sl = NUM2LONG(other);
-        oci_lc(OCINumberFromInt(oci8_errhp, &sl, sizeof(sl), OCI_NUMBER_SIGNED, &n));
-        return rb_assoc_new(oci8_make_ocinumber(&n, oci8_errhp), self);
     case T_BIGNUM:
-        /* change via string. */
-        other = rb_big2str(other, 10);
-        set_oci_number_from_str(&n, other, Qnil, Qnil, oci8_errhp);
-        return rb_assoc_new(oci8_make_ocinumber(&n, oci8_errhp), self);
+        set_oci_number_from_int(&n, other);
+        return rb_assoc_new(make_ocinumber(&n), self);
     case T_FLOAT:
         return rb_assoc_new(other, onum_to_f(self));
     case RBOCI8_T_RATIONAL:
@@ -752,11 +989,12 @@ static VALUE onum_coerce(VALUE self, VALUE other)
  */
 static VALUE onum_neg(VALUE self)
 {
-    OCIError *errhp = oci8_errhp;
     OCINumber r;
 
-    oci_lc(OCINumberNeg(errhp, _NUMBER(self), &r));
-    return oci8_make_ocinumber(&r, errhp);
+    if (oranumber_neg(&r, _NUMBER(self)) != ORANUMBER_SUCCESS) {
+        oci_lc(OCINumberNeg(oci8_errhp, _NUMBER(self), &r));
+    }
+    return make_ocinumber(&r);
 }
 
 
@@ -768,21 +1006,22 @@ static VALUE onum_neg(VALUE self)
  */
 static VALUE onum_add(VALUE lhs, VALUE rhs)
 {
-    OCIError *errhp = oci8_errhp;
     OCINumber n;
     OCINumber r;
 
     switch (rboci8_type(rhs)) {
     case T_FIXNUM:
     case T_BIGNUM:
-        if (set_oci_number_from_num(&n, rhs, 0, errhp)) {
-            oci_lc(OCINumberAdd(errhp, _NUMBER(lhs), &n, &r));
-            return oci8_make_ocinumber(&r, errhp);
+        set_oci_number_from_int(&n, rhs);
+        if (oranumber_add(&r, _NUMBER(lhs), &n) != ORANUMBER_SUCCESS) {
+            oci_lc(OCINumberAdd(oci8_errhp, _NUMBER(lhs), &n, &r));
         }
-        break;
+        return make_ocinumber(&r);
     case RBOCI8_T_ORANUMBER:
-        oci_lc(OCINumberAdd(errhp, _NUMBER(lhs), _NUMBER(rhs), &r));
-        return oci8_make_ocinumber(&r, errhp);
+        if (oranumber_add(&r, _NUMBER(lhs), _NUMBER(rhs)) != ORANUMBER_SUCCESS) {
+            oci_lc(OCINumberAdd(oci8_errhp, _NUMBER(lhs), _NUMBER(rhs), &r));
+        }
+        return make_ocinumber(&r);
     case T_FLOAT:
         return rb_funcall(onum_to_f(lhs), oci8_id_add_op, 1, rhs);
     case RBOCI8_T_RATIONAL:
@@ -802,21 +1041,22 @@ static VALUE onum_add(VALUE lhs, VALUE rhs)
  */
 static VALUE onum_sub(VALUE lhs, VALUE rhs)
 {
-    OCIError *errhp = oci8_errhp;
     OCINumber n;
     OCINumber r;
 
     switch (rboci8_type(rhs)) {
     case T_FIXNUM:
     case T_BIGNUM:
-        if (set_oci_number_from_num(&n, rhs, 0, errhp)) {
-            oci_lc(OCINumberSub(errhp, _NUMBER(lhs), &n, &r));
-            return oci8_make_ocinumber(&r, errhp);
+        set_oci_number_from_int(&n, rhs);
+        if (oranumber_sub(&r, _NUMBER(lhs), &n) != ORANUMBER_SUCCESS) {
+            oci_lc(OCINumberSub(oci8_errhp, _NUMBER(lhs), &n, &r));
         }
-        break;
+        return make_ocinumber(&r);
     case RBOCI8_T_ORANUMBER:
-        oci_lc(OCINumberSub(errhp, _NUMBER(lhs), _NUMBER(rhs), &r));
-        return oci8_make_ocinumber(&r, errhp);
+        if (oranumber_sub(&r, _NUMBER(lhs), _NUMBER(rhs)) != ORANUMBER_SUCCESS) {
+            oci_lc(OCINumberSub(oci8_errhp, _NUMBER(lhs), _NUMBER(rhs), &r));
+        }
+        return make_ocinumber(&r);
     case T_FLOAT:
         return rb_funcall(onum_to_f(lhs), oci8_id_sub_op, 1, rhs);
     case RBOCI8_T_RATIONAL:
@@ -835,21 +1075,22 @@ static VALUE onum_sub(VALUE lhs, VALUE rhs)
  */
 static VALUE onum_mul(VALUE lhs, VALUE rhs)
 {
-    OCIError *errhp = oci8_errhp;
     OCINumber n;
     OCINumber r;
 
     switch (rboci8_type(rhs)) {
     case T_FIXNUM:
     case T_BIGNUM:
-        if (set_oci_number_from_num(&n, rhs, 0, errhp)) {
-            oci_lc(OCINumberMul(errhp, _NUMBER(lhs), &n, &r));
-            return oci8_make_ocinumber(&r, errhp);
+        set_oci_number_from_int(&n, rhs);
+        if (oranumber_mul(&r, _NUMBER(lhs), &n) != ORANUMBER_SUCCESS) {
+            oci_lc(OCINumberMul(oci8_errhp, _NUMBER(lhs), &n, &r));
         }
-        break;
+        return make_ocinumber(&r);
     case RBOCI8_T_ORANUMBER:
-        oci_lc(OCINumberMul(errhp, _NUMBER(lhs), _NUMBER(rhs), &r));
-        return oci8_make_ocinumber(&r, errhp);
+        if (oranumber_mul(&r, _NUMBER(lhs), _NUMBER(rhs)) != ORANUMBER_SUCCESS) {
+            oci_lc(OCINumberMul(oci8_errhp, _NUMBER(lhs), _NUMBER(rhs), &r));
+        }
+        return make_ocinumber(&r);
     case T_FLOAT:
         return rb_funcall(onum_to_f(lhs), oci8_id_mul_op, 1, rhs);
     case RBOCI8_T_RATIONAL:
@@ -960,15 +1201,30 @@ static VALUE onum_power(VALUE lhs, VALUE rhs)
  */
 static VALUE onum_cmp(VALUE lhs, VALUE rhs)
 {
-    OCIError *errhp = oci8_errhp;
     OCINumber n;
-    sword r;
+    OCINumber *rhs_num = &n;
+    int r;
 
     /* change to OCINumber */
-    if (!set_oci_number_from_num(&n, rhs, 0, errhp))
-        return rb_num_coerce_cmp(lhs, rhs, id_cmp);
+    switch (rboci8_type(rhs)) {
+    case T_FIXNUM:
+    case T_BIGNUM:
+        set_oci_number_from_int(&n, rhs);
+        break;
+    case RBOCI8_T_ORANUMBER:
+        rhs_num = _NUMBER(rhs);
+        break;
+    default:
+        if (!set_oci_number_from_num(&n, rhs, 0, oci8_errhp))
+            return rb_num_coerce_cmp(lhs, rhs, id_cmp);
+    }
     /* compare */
-    oci_lc(OCINumberCmp(errhp, _NUMBER(lhs), &n, &r));
+    if (oranumber_cmp(_NUMBER(lhs), rhs_num, &r) != ORANUMBER_SUCCESS) {
+        sword sr;
+
+        oci_lc(OCINumberCmp(oci8_errhp, _NUMBER(lhs), rhs_num, &sr));
+        r = sr;
+    }
     if (r > 0) {
         return INT2FIX(1);
     } else if (r == 0) {
@@ -986,11 +1242,12 @@ static VALUE onum_cmp(VALUE lhs, VALUE rhs)
  */
 static VALUE onum_floor(VALUE self)
 {
-    OCIError *errhp = oci8_errhp;
     OCINumber r;
 
-    oci_lc(OCINumberFloor(errhp, _NUMBER(self), &r));
-    return oci8_make_integer(&r, errhp);
+    if (oranumber_round(&r, _NUMBER(self), 0, ORANUMBER_FLOOR) != ORANUMBER_SUCCESS) {
+        oci_lc(OCINumberFloor(oci8_errhp, _NUMBER(self), &r));
+    }
+    return oci8_make_integer(&r, oci8_errhp);
 }
 
 /*
@@ -1002,11 +1259,12 @@ static VALUE onum_floor(VALUE self)
  */
 static VALUE onum_ceil(VALUE self)
 {
-    OCIError *errhp = oci8_errhp;
     OCINumber r;
 
-    oci_lc(OCINumberCeil(errhp, _NUMBER(self), &r));
-    return oci8_make_integer(&r, errhp);
+    if (oranumber_round(&r, _NUMBER(self), 0, ORANUMBER_CEIL) != ORANUMBER_SUCCESS) {
+        oci_lc(OCINumberCeil(oci8_errhp, _NUMBER(self), &r));
+    }
+    return oci8_make_integer(&r, oci8_errhp);
 }
 
 /*
@@ -1023,16 +1281,19 @@ static VALUE onum_ceil(VALUE self)
  */
 static VALUE onum_round(int argc, VALUE *argv, VALUE self)
 {
-    OCIError *errhp = oci8_errhp;
     VALUE decplace;
+    int dp;
     OCINumber r;
 
     rb_scan_args(argc, argv, "01", &decplace /* 0 */);
-    oci_lc(OCINumberRound(errhp, _NUMBER(self), NIL_P(decplace) ? 0 : NUM2INT(decplace), &r));
+    dp = NIL_P(decplace) ? 0 : NUM2INT(decplace);
+    if (oranumber_round(&r, _NUMBER(self), dp, ORANUMBER_ROUND) != ORANUMBER_SUCCESS) {
+        oci_lc(OCINumberRound(oci8_errhp, _NUMBER(self), dp, &r));
+    }
     if (argc == 0) {
-        return oci8_make_integer(&r, errhp);
+        return oci8_make_integer(&r, oci8_errhp);
     } else {
-        return oci8_make_ocinumber(&r, errhp);
+        return make_ocinumber(&r);
     }
 }
 
@@ -1046,13 +1307,16 @@ static VALUE onum_round(int argc, VALUE *argv, VALUE self)
  */
 static VALUE onum_trunc(int argc, VALUE *argv, VALUE self)
 {
-    OCIError *errhp = oci8_errhp;
     VALUE decplace;
+    int dp;
     OCINumber r;
 
     rb_scan_args(argc, argv, "01", &decplace /* 0 */);
-    oci_lc(OCINumberTrunc(errhp, _NUMBER(self), NIL_P(decplace) ? 0 : NUM2INT(decplace), &r));
-    return oci8_make_ocinumber(&r, errhp);
+    dp = NIL_P(decplace) ? 0 : NUM2INT(decplace);
+    if (oranumber_round(&r, _NUMBER(self), dp, ORANUMBER_TRUNC) != ORANUMBER_SUCCESS) {
+        oci_lc(OCINumberTrunc(oci8_errhp, _NUMBER(self), dp, &r));
+    }
+    return make_ocinumber(&r);
 }
 
 /*
@@ -1151,11 +1415,8 @@ static VALUE onum_to_s(VALUE self)
  */
 static VALUE onum_to_i(VALUE self)
 {
-    OCIError *errhp = oci8_errhp;
-    OCINumber num;
-
-    oci_lc(OCINumberTrunc(errhp, _NUMBER(self), 0, &num));
-    return oci8_make_integer(&num, errhp);
+    /* oci8_make_integer() truncates the fractional part. */
+    return oci8_make_integer(_NUMBER(self), oci8_errhp);
 }
 
 /*
@@ -1228,14 +1489,22 @@ static VALUE onum_to_d(VALUE self)
 /* Converts to BigDecimal via number in scientific notation */
 static VALUE onum_to_d_real(OCINumber *num, OCIError *errhp)
 {
-    char buf[64];
+    char buf[256];
     ub4 buf_size = sizeof(buf);
     const char *fmt = "FM9.99999999999999999999999999999999999999EEEE";
+    int rv;
 
     if (!cBigDecimal) {
         rb_require("bigdecimal");
         cBigDecimal = rb_const_get(rb_cObject, id_BigDecimal);
     }
+    /* BigDecimal's internals are not public. Create it from a string
+     * made by oranumber_to_str() without calling OCI functions.
+     */
+    rv = oranumber_to_str(num, buf, sizeof(buf));
+    if (rv > 0) {
+        return rb_funcall(rb_cObject, id_BigDecimal, 1, rb_usascii_str_new(buf, rv));
+    }
     oci_lc(OCINumberToText(errhp, num, (const oratext *)fmt, strlen(fmt),
                            NULL, 0, &buf_size, TO_ORATEXT(buf)));
     return rb_funcall(rb_cObject, id_BigDecimal, 1, rb_usascii_str_new(buf, buf_size));
@@ -1296,11 +1565,12 @@ static VALUE onum_zero_p(VALUE self)
  */
 static VALUE onum_abs(VALUE self)
 {
-    OCIError *errhp = oci8_errhp;
     OCINumber result;
 
-    oci_lc(OCINumberAbs(errhp, _NUMBER(self), &result));
-    return oci8_make_ocinumber(&result, errhp);
+    if (oranumber_abs(&result, _NUMBER(self)) != ORANUMBER_SUCCESS) {
+        oci_lc(OCINumberAbs(oci8_errhp, _NUMBER(self), &result));
+    }
+    return make_ocinumber(&result);
 }
 
 /*
@@ -1337,21 +1607,50 @@ static VALUE onum_dump(VALUE self)
     return rb_usascii_str_new(buf, rv);
 }
 
+/*
+ * Hashes the internal format by FNV-1a. Equal numbers have the same
+ * bytes because Oracle numbers are normalized.
+ */
 static VALUE onum_hash(VALUE self)
 {
-    char *c  = DATA_PTR(self);
+    const ub1 *c = _NUMBER(self)->OCINumberPart;
     int size = c[0] + 1;
-    int i, hash;
+    unsigned long hash = 2166136261UL;
+    int i;
 
     /* assert(size <= 22); ?*/
     if (size > 22)
         size = 22;
 
-    for (hash = 0, i = 1; i< size; i++) {
-        hash += c[i] * 971;
+    for (i = 0; i < size; i++) {
+        hash ^= c[i];
+        hash *= 16777619UL;
     }
-    if (hash < 0) hash = -hash;
-    return INT2FIX(hash);
+    return INT2FIX(hash & 0x3fffffff);
+}
+
+/*
+ *  call-seq:
+ *     onum.eql?(other)    -> true or false
+ *
+ *  Returns <code>true</code> if <i>other</i> is an <code>OraNumber</code>
+ *  with the same value. This and <code>hash</code> make
+ *  <code>OraNumber</code> usable as a <code>Hash</code> key.
+ */
+static VALUE onum_eql_p(VALUE lhs, VALUE rhs)
+{
+    const ub1 *c1;
+    const ub1 *c2;
+
+    if (rboci8_type(rhs) != RBOCI8_T_ORANUMBER) {
+        return Qfalse;
+    }
+    c1 = _NUMBER(lhs)->OCINumberPart;
+    c2 = _NUMBER(rhs)->OCINumberPart;
+    if (c1[0] != c2[0] || c1[0] > 21) {
+        return Qfalse;
+    }
+    return memcmp(c1 + 1, c2 + 1, c1[0]) == 0 ? Qtrue : Qfalse;
 }
 
 static VALUE onum_inspect(VALUE self)
@@ -1424,6 +1723,19 @@ static VALUE bind_float_get(oci8_bind_t *obind, void *data, void *null_struct)
     return oci8_make_float((OCINumber*)data, oci8_errhp);
 }
 
+static VALUE bind_basic_number_get(oci8_bind_t *obind, void *data, void *null_struct)
+{
+    OCIError *errhp = oci8_errhp;
+    boolean is_int;
+
+    oci_lc(OCINumberIsInt(errhp, (OCINumber*)data, &is_int));
+    if (is_int) {
+        return oci8_make_integer((OCINumber*)data, errhp);
+    } else {
+        return oci8_make_float((OCINumber*)data, errhp);
+    }
+}
+
 static void bind_ocinumber_set(oci8_bind_t *obind, void *data, void **null_structp, VALUE val)
 {
     set_oci_number_from_num((OCINumber*)data, val, 1, oci8_errhp);
@@ -1496,6 +1808,38 @@ static const oci8_bind_class_t bind_float_class = {
     SQLT_VNU,
 };
 
+static const oci8_bind_class_t bind_basic_number_class = {
+    {
+        NULL,
+        oci8_bind_free,
+        sizeof(oci8_bind_t)
+    },
+    bind_basic_number_get,
+    bind_ocinumber_set,
+    bind_ocinumber_init,
+    bind_ocinumber_init_elem,
+    NULL,
+    SQLT_VNU,
+};
+
+/*
+ * Returns the pack(1) template character of values packed by
+ * OCI8::Cursor#fetch_packed: 'q' for OCI8::BindType::Integer, 'D'
+ * for OCI8::BindType::Float and zero for other NUMBER defines.
+ */
+int oci8_number_bind_pack_type(const oci8_bind_t *obind)
+{
+    const oci8_bind_class_t *obc = (const oci8_bind_class_t *)obind->base.klass;
+
+    if (obc == &bind_integer_class) {
+        return 'q';
+    }
+    if (obc == &bind_float_class) {
+        return 'D';
+    }
+    return 0;
+}
+
 void
 Init_oci_number(VALUE cOCI8, OCIError *errhp)
 {
@@ -1508,6 +1852,7 @@ Init_oci_number(VALUE cOCI8, OCIError *errhp)
     id_cmp = rb_intern("<=>");
     id_finite_p = rb_intern("finite?");
     id_split = rb_intern("split");
+    id_to_s = rb_intern("to_s");
     id_numerator = rb_intern("numerator");
     id_denominator = rb_intern("denominator");
     id_Rational = rb_intern("Rational");
@@ -1607,6 +1952,7 @@ Init_oci_number(VALUE cOCI8, OCIError *errhp)
     rb_define_method(cOCINumber, "dump", onum_dump, 0);
 
     rb_define_method_nodoc(cOCINumber, "hash", onum_hash, 0);
+    rb_define_method(cOCINumber, "eql?", onum_eql_p, 1);
     rb_define_method_nodoc(cOCINumber, "inspect", onum_inspect, 0);
 
     /* methods for marshaling */
@@ -1616,6 +1962,7 @@ Init_oci_number(VALUE cOCI8, OCIError *errhp)
     oci8_define_bind_class("OraNumber", &bind_ocinumber_class);
     oci8_define_bind_class("Integer", &bind_integer_class);
     oci8_define_bind_class("Float", &bind_float_class);
+    oci8_define_bind_class("BasicNumberType", &bind_basic_number_class);
 }
 
 OCINumber *oci8_get_ocinumber(VALUE num)
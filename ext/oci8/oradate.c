@@ -13,6 +13,10 @@
 #include <time.h>
 
 static VALUE cOraDate;
+static VALUE cDate = Qnil;
+static ID id_year;
+static ID id_mon;
+static ID id_mday;
 
 /*
  * Document-class: OraDate
@@ -557,6 +561,49 @@ static void bind_oradate_init_elem(oci8_bind_t *obind, VALUE svc)
     } while (++idx < obind->maxar_sz);
 }
 
+/*
+ * Document-class: OCI8::BindType::Date
+ *
+ * This is a helper class to bind Date as Oracle's <tt>DATE</tt> datatype.
+ *
+ */
+static VALUE bind_date_get(oci8_bind_t *obind, void *data, void *null_struct)
+{
+    ora_date_t *od = (ora_date_t *)data;
+
+    if (NIL_P(cDate)) {
+        cDate = rb_const_get(rb_cObject, rb_intern("Date"));
+    }
+    return rb_funcall(cDate, oci8_id_new, 3, INT2FIX(Get_year(od)), INT2FIX(Get_month(od)), INT2FIX(Get_day(od)));
+}
+
+static void bind_date_set(oci8_bind_t *obind, void *data, void **null_structp, VALUE val)
+{
+    ora_date_t *od = (ora_date_t *)data;
+    int year = NUM2INT(rb_funcall(val, id_year, 0));
+    int month = NUM2INT(rb_funcall(val, id_mon, 0));
+    int day = NUM2INT(rb_funcall(val, id_mday, 0));
+
+    Check_year(year);
+    Check_month(month);
+    Check_day(day);
+    oci8_set_ora_date(od, year, month, day, 0, 0, 0);
+}
+
+static const oci8_bind_class_t bind_date_class = {
+    {
+        NULL,
+        oci8_bind_free,
+        sizeof(oci8_bind_t)
+    },
+    bind_date_get,
+    bind_date_set,
+    bind_oradate_init,
+    bind_oradate_init_elem,
+    NULL,
+    SQLT_DAT,
+};
+
 static const oci8_bind_class_t bind_oradate_class = {
     {
         NULL,
@@ -574,6 +621,10 @@ static const oci8_bind_class_t bind_oradate_class = {
 void Init_ora_date(void)
 {
     cOraDate = rb_define_class("OraDate", rb_cObject);
+    rb_global_variable(&cDate);
+    id_year = rb_intern("year");
+    id_mon = rb_intern("mon");
+    id_mday = rb_intern("mday");
 
     rb_define_alloc_func(cOraDate, ora_date_s_allocate);
     rb_define_method(cOraDate, "initialize", ora_date_initialize, -1);
@@ -611,4 +662,5 @@ void Init_ora_date(void)
     rb_define_singleton_method(cOraDate, "_load", ora_date_s_load, 1);
 
     oci8_define_bind_class("OraDate", &bind_oradate_class);
+    oci8_define_bind_class("Date", &bind_date_class);
 }
@@ -1,6 +1,8 @@
 /* -*- c-file-style: "ruby"; indent-tabs-mode: nil -*- */
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "oranumber_util.h"
 
 int oranumber_to_str(const OCINumber *on, char *buf, int buflen)
@@ -130,7 +132,6 @@ int oranumber_from_str(OCINumber *on, const char *buf, int buflen)
     int dec_point;
     long exponent = 0;
     int idx = 0;
-    int i;
 
     if (buflen < 0) {
         end = buf + strlen(buf);
@@ -263,8 +264,22 @@ int oranumber_from_str(OCINumber *on, const char *buf, int buflen)
     if (buf != end) {
         return ORANUMBER_INVALID_NUMBER;
     }
-    /* determine exponent */
-    exponent += dec_point - 1;
+    return oranumber_from_mantissa(on, is_positive, mantissa, idx, exponent + dec_point - 1);
+}
+
+/*
+ * Constructs an OCINumber from decimal digits.
+ *
+ * mantissa must be a 41-byte buffer whose first idx elements are
+ * digits without leading zeros. idx may be larger than 41. In that
+ * case, the buffer holds the first 41 digits and the value is rounded
+ * by them.
+ * exponent is the decimal exponent of the first digit.
+ */
+int oranumber_from_mantissa(OCINumber *on, int is_positive, char *mantissa, int idx, long exponent)
+{
+    int i;
+
     if (exponent % 2 == 0) {
         memmove(mantissa + 1, mantissa, 40);
         mantissa[0] = 0;
@@ -334,6 +349,922 @@ int oranumber_from_str(OCINumber *on, const char *buf, int buflen)
     return ORANUMBER_SUCCESS;
 }
 
+/*
+ * Converts the integer part of an OCINumber to a 64-bit signed integer.
+ * The fractional part is truncated.
+ *
+ * It returns ORANUMBER_NUMERIC_OVERFLOW when the value, including
+ * infinity, doesn't fit in 64 bits and ORANUMBER_INVALID_INTERNAL_FORMAT
+ * when the internal format is broken.
+ */
+int oranumber_to_int64(const OCINumber *on, oranumber_int64 *out)
+{
+    int datalen = on->OCINumberPart[0];
+    const ub1 *mantissa = on->OCINumberPart + 2;
+    int is_positive;
+    int exponent;
+    int idx;
+    int n;
+    oranumber_uint64 limit;
+    oranumber_uint64 val = 0;
+
+    if (datalen == 0 || datalen > 21) {
+        return ORANUMBER_INVALID_INTERNAL_FORMAT;
+    }
+    if (datalen == 1) {
+        if (on->OCINumberPart[1] == 0x80) {
+            /* zero */
+            *out = 0;
+            return ORANUMBER_SUCCESS;
+        }
+        if (on->OCINumberPart[1] == 0) {
+            /* negative infinity */
+            return ORANUMBER_NUMERIC_OVERFLOW;
+        }
+        return ORANUMBER_INVALID_INTERNAL_FORMAT;
+    }
+    if (datalen == 2 && on->OCINumberPart[1] == 255 && on->OCINumberPart[2] == 101) {
+        /* positive infinity */
+        return ORANUMBER_NUMERIC_OVERFLOW;
+    }
+    datalen--; /* number of base-100 digits */
+    if (on->OCINumberPart[1] >= 128) {
+        is_positive = 1;
+        exponent = on->OCINumberPart[1] - 193;
+        limit = ((oranumber_uint64)1 << 63) - 1;
+    } else {
+        is_positive = 0;
+        exponent = 62 - on->OCINumberPart[1];
+        limit = (oranumber_uint64)1 << 63;
+        if (mantissa[datalen - 1] == 102) {
+            /* negative value's terminator */
+            datalen--;
+        }
+    }
+    if (exponent < 0) {
+        /* absolute value is less than one. */
+        *out = 0;
+        return ORANUMBER_SUCCESS;
+    }
+    if (exponent > 9) {
+        /* 100^10 > 2^64 */
+        return ORANUMBER_NUMERIC_OVERFLOW;
+    }
+    for (idx = 0; idx <= exponent; idx++) {
+        if (idx < datalen) {
+            n = is_positive ? (mantissa[idx] - 1) : (101 - mantissa[idx]);
+            if (n < 0 || 99 < n) {
+                return ORANUMBER_INVALID_INTERNAL_FORMAT;
+            }
+        } else {
+            n = 0;
+        }
+        if (val > (limit - n) / 100) {
+            return ORANUMBER_NUMERIC_OVERFLOW;
+        }
+        val = val * 100 + n;
+    }
+    if (is_positive || val == 0) {
+        *out = (oranumber_int64)val;
+    } else {
+        *out = -(oranumber_int64)(val - 1) - 1;
+    }
+    return ORANUMBER_SUCCESS;
+}
+
+/*
+ * A fixed size unsigned big integer used to convert an OCINumber to
+ * a double. 768 bits are enough for 10^40 * 10^126 and 2 * 10^170.
+ */
+#define BIGNUM_LIMBS 24
+typedef struct {
+    int len; /* number of used limbs */
+    ub4 limb[BIGNUM_LIMBS]; /* 32-bit limbs in little endian */
+} bignum_t;
+
+static void bignum_mul_add(bignum_t *bn, ub4 mul, ub4 add)
+{
+    oranumber_uint64 carry = add;
+    int idx;
+
+    for (idx = 0; idx < bn->len; idx++) {
+        carry += (oranumber_uint64)bn->limb[idx] * mul;
+        bn->limb[idx] = (ub4)carry;
+        carry >>= 32;
+    }
+    if (carry != 0) {
+        bn->limb[bn->len++] = (ub4)carry;
+    }
+}
+
+/* multiplies by 10^exponent */
+static void bignum_mul_pow10(bignum_t *bn, int exponent)
+{
+    static const ub4 pow10[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+    };
+
+    for (; exponent >= 9; exponent -= 9) {
+        bignum_mul_add(bn, pow10[9], 0);
+    }
+    bignum_mul_add(bn, pow10[exponent], 0);
+}
+
+static int bignum_bitlen(const bignum_t *bn)
+{
+    int bits;
+    ub4 top;
+
+    if (bn->len == 0) {
+        return 0;
+    }
+    top = bn->limb[bn->len - 1];
+    for (bits = 0; top != 0; bits++) {
+        top >>= 1;
+    }
+    return (bn->len - 1) * 32 + bits;
+}
+
+static void bignum_shl(bignum_t *bn, int bits)
+{
+    int words = bits / 32;
+    int idx;
+
+    bits %= 32;
+    if (bn->len == 0) {
+        return;
+    }
+    if (bits != 0) {
+        ub4 carry = 0;
+
+        for (idx = 0; idx < bn->len; idx++) {
+            ub4 v = bn->limb[idx];
+            bn->limb[idx] = (v << bits) | carry;
+            carry = v >> (32 - bits);
+        }
+        if (carry != 0) {
+            bn->limb[bn->len++] = carry;
+        }
+    }
+    if (words != 0) {
+        memmove(bn->limb + words, bn->limb, bn->len * sizeof(ub4));
+        memset(bn->limb, 0, words * sizeof(ub4));
+        bn->len += words;
+    }
+}
+
+static int bignum_cmp(const bignum_t *a, const bignum_t *b)
+{
+    int idx;
+
+    if (a->len != b->len) {
+        return a->len < b->len ? -1 : 1;
+    }
+    for (idx = a->len - 1; idx >= 0; idx--) {
+        if (a->limb[idx] != b->limb[idx]) {
+            return a->limb[idx] < b->limb[idx] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/* a -= b where a >= b */
+static void bignum_sub(bignum_t *a, const bignum_t *b)
+{
+    oranumber_int64 borrow = 0;
+    int idx;
+
+    for (idx = 0; idx < a->len; idx++) {
+        borrow += (oranumber_int64)a->limb[idx] - (idx < b->len ? b->limb[idx] : 0);
+        a->limb[idx] = (ub4)borrow;
+        borrow = (borrow < 0) ? -1 : 0;
+    }
+    while (a->len > 0 && a->limb[a->len - 1] == 0) {
+        a->len--;
+    }
+}
+
+/*
+ * Returns the double nearest to (base-100 digits) * 10^exponent,
+ * rounding half to even. The quotient a / b is scaled to [1, 2) by
+ * a power of two and its 53 bits, a round bit and a sticky bit are
+ * got by long division.
+ */
+static double base100_to_double(const int *digits, int ndigits, int exponent)
+{
+    bignum_t a, b;
+    oranumber_uint64 mant = 0;
+    int k;
+    int idx;
+
+    a.len = 0;
+    for (idx = 0; idx < ndigits; idx++) {
+        bignum_mul_add(&a, 100, digits[idx]);
+    }
+    b.len = 1;
+    b.limb[0] = 1;
+    if (exponent >= 0) {
+        bignum_mul_pow10(&a, exponent);
+    } else {
+        bignum_mul_pow10(&b, -exponent);
+    }
+    /* a / b * 2^k is the value after scaling a / b to [1, 2). */
+    k = bignum_bitlen(&a) - bignum_bitlen(&b);
+    if (k >= 0) {
+        bignum_shl(&b, k);
+    } else {
+        bignum_shl(&a, -k);
+    }
+    if (bignum_cmp(&a, &b) < 0) {
+        bignum_shl(&a, 1);
+        k--;
+    }
+    for (idx = 0; idx < 54; idx++) {
+        mant <<= 1;
+        if (bignum_cmp(&a, &b) >= 0) {
+            bignum_sub(&a, &b);
+            mant |= 1;
+        }
+        bignum_shl(&a, 1);
+    }
+    /* mant has 53 bits and a round bit. a is the sticky bit. */
+    if ((mant & 1) && (a.len != 0 || (mant & 2))) {
+        mant += 2;
+    }
+    mant >>= 1;
+    if (mant == ((oranumber_uint64)1 << 53)) {
+        mant >>= 1;
+        k++;
+    }
+    return ldexp((double)mant, k - 52);
+}
+
+/*
+ * Converts an OCINumber to the nearest double.
+ *
+ * When the decimal mantissa fits in 53 bits and the decimal exponent
+ * is within the range of exactly representable powers of ten, one
+ * floating point operation gives the correctly rounded result.
+ * Other values are converted by base100_to_double().
+ */
+int oranumber_to_double(const OCINumber *on, double *out)
+{
+    static const double pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    const oranumber_uint64 max_mantissa = (oranumber_uint64)1 << 53;
+    int datalen = on->OCINumberPart[0];
+    const ub1 *mantissa = on->OCINumberPart + 2;
+    int digits[20];
+    int is_positive;
+    int exponent;
+    int idx;
+    int n;
+    oranumber_uint64 val = 0;
+    double dbl;
+
+    if (datalen == 0 || datalen > 21) {
+        return ORANUMBER_INVALID_INTERNAL_FORMAT;
+    }
+    if (datalen == 1) {
+        if (on->OCINumberPart[1] == 0x80) {
+            /* zero */
+            *out = 0.0;
+            return ORANUMBER_SUCCESS;
+        }
+        if (on->OCINumberPart[1] == 0) {
+            /* negative infinity */
+            *out = -HUGE_VAL;
+            return ORANUMBER_SUCCESS;
+        }
+        return ORANUMBER_INVALID_INTERNAL_FORMAT;
+    }
+    if (datalen == 2 && on->OCINumberPart[1] == 255 && on->OCINumberPart[2] == 101) {
+        /* positive infinity */
+        *out = HUGE_VAL;
+        return ORANUMBER_SUCCESS;
+    }
+    datalen--; /* number of base-100 digits */
+    if (on->OCINumberPart[1] >= 128) {
+        is_positive = 1;
+        exponent = on->OCINumberPart[1] - 193;
+    } else {
+        is_positive = 0;
+        exponent = 62 - on->OCINumberPart[1];
+        if (mantissa[datalen - 1] == 102) {
+            /* negative value's terminator */
+            datalen--;
+        }
+    }
+    for (idx = 0; idx < datalen; idx++) {
+        n = is_positive ? (mantissa[idx] - 1) : (101 - mantissa[idx]);
+        if (n < 0 || 99 < n) {
+            return ORANUMBER_INVALID_INTERNAL_FORMAT;
+        }
+        digits[idx] = n;
+        if (idx < 9) {
+            /* up to 18 decimal digits */
+            val = val * 100 + n;
+        }
+    }
+    /* the value is (digits) * 10^exponent from here. */
+    exponent = (exponent - datalen + 1) * 2;
+    if (datalen > 9 || val > max_mantissa || exponent < -22) {
+        dbl = base100_to_double(digits, datalen, exponent);
+    } else {
+        dbl = (double)val;
+        if (exponent < 0) {
+            dbl /= pow10[-exponent];
+        } else if (exponent <= 22) {
+            dbl *= pow10[exponent];
+        } else {
+            int exp = exponent;
+
+            /* move extra zeros to the mantissa if it is still exact. */
+            for (; exp > 22 && val <= max_mantissa / 10; exp--) {
+                val *= 10;
+            }
+            if (exp > 22) {
+                dbl = base100_to_double(digits, datalen, exponent);
+            } else {
+                dbl = (double)val * pow10[22];
+            }
+        }
+    }
+    *out = is_positive ? dbl : -dbl;
+    return ORANUMBER_SUCCESS;
+}
+
+/*
+ * Writes the nearest prec-digit decimal of a positive double to
+ * mantissa and exponent.
+ */
+static void double_to_digits(double dbl, int prec, char *mantissa, int *exponent)
+{
+    char buf[40];
+    const char *p;
+    int idx = 0;
+
+    snprintf(buf, sizeof(buf), "%.*e", prec - 1, dbl);
+    /* buf is "d.ddde+dd". The decimal point depends on the locale. */
+    for (p = buf; *p != 'e'; p++) {
+        if ('0' <= *p && *p <= '9') {
+            mantissa[idx++] = *p - '0';
+        }
+    }
+    *exponent = atoi(p + 1);
+}
+
+/*
+ * Converts decimal digits back to a double. The decimal point
+ * is not used to be independent of the locale.
+ */
+static double digits_to_double(const char *mantissa, int idx, int exponent)
+{
+    char buf[40];
+    int i;
+
+    for (i = 0; i < idx; i++) {
+        buf[i] = mantissa[i] + '0';
+    }
+    sprintf(buf + idx, "e%d", exponent - idx + 1);
+    return strtod(buf, NULL);
+}
+
+/*
+ * Converts a double to an OCINumber with the shortest decimal digits
+ * which are converted back to the same double. The digits are same
+ * with those of Float#to_s.
+ *
+ * The nearest 15-digit decimal is the shortest one when it is
+ * converted back to the double because DBL_DIG is 15. Otherwise
+ * the nearest 16-digit or 17-digit one is used. When the double is
+ * a power of two, the rounding interval below it is half of that
+ * above it. The next 16-digit decimal above it is checked also.
+ */
+int oranumber_from_double(OCINumber *on, double dbl)
+{
+    char mantissa[41];
+    int is_positive = 1;
+    int exponent;
+    int exp2;
+    int is_power_of_two;
+    int idx;
+    int i;
+
+    if (dbl != dbl) {
+        /* NaN */
+        return ORANUMBER_INVALID_NUMBER;
+    }
+    if (dbl < 0.0) {
+        is_positive = 0;
+        dbl = -dbl;
+    }
+    if (dbl == HUGE_VAL) {
+        if (is_positive) {
+            /* positive infinity */
+            on->OCINumberPart[0] = 2;
+            on->OCINumberPart[1] = 255;
+            on->OCINumberPart[2] = 101;
+        } else {
+            /* negative infinity */
+            on->OCINumberPart[0] = 1;
+            on->OCINumberPart[1] = 0;
+        }
+        return ORANUMBER_SUCCESS;
+    }
+    if (dbl < 1e-200) {
+        /* zero or underflow. This excludes subnormal numbers also. */
+        on->OCINumberPart[0] = 1;
+        on->OCINumberPart[1] = 0x80;
+        return ORANUMBER_SUCCESS;
+    }
+    is_power_of_two = (frexp(dbl, &exp2) == 0.5);
+    for (idx = 15; idx < 17; idx++) {
+        double_to_digits(dbl, idx, mantissa, &exponent);
+        if (digits_to_double(mantissa, idx, exponent) == dbl) {
+            break;
+        }
+        if (is_power_of_two) {
+            /* round up the last digit */
+            for (i = idx - 1; i >= 0; i--) {
+                if (++mantissa[i] != 10) {
+                    break;
+                }
+                mantissa[i] = 0;
+            }
+            if (i == -1) {
+                mantissa[0] = 1;
+                exponent++;
+            }
+            if (digits_to_double(mantissa, idx, exponent) == dbl) {
+                break;
+            }
+        }
+    }
+    if (idx == 17) {
+        /* 17 digits are always enough. */
+        double_to_digits(dbl, idx, mantissa, &exponent);
+    }
+    return oranumber_from_mantissa(on, is_positive, mantissa, idx, exponent);
+}
+
+/*
+ * Base-100 arithmetic without OCI calls.
+ *
+ * The following functions return ORANUMBER_SUCCESS only when the
+ * result is exact and has at most 38 significant decimal digits.
+ * Otherwise, including infinity and exponent overflow, they return
+ * ORANUMBER_INEXACT_RESULT and the caller must use the corresponding
+ * OCINumber function, whose rounding and error reporting are kept.
+ */
+
+/* 40 digits for a product or an aligned sum and one for the carry */
+#define ORANUMBER_WORK_DIGITS 41
+
+typedef struct {
+    int sign;     /* 1, -1 or 0 */
+    int exponent; /* base-100 exponent of digits[0] */
+    int len;      /* number of base-100 digits */
+    int digits[ORANUMBER_WORK_DIGITS];
+} oranumber_parts_t;
+
+static int oranumber_decode(const OCINumber *on, oranumber_parts_t *p)
+{
+    int datalen = on->OCINumberPart[0];
+    const ub1 *mantissa = on->OCINumberPart + 2;
+    int idx;
+    int n;
+
+    if (datalen == 0 || datalen > 21) {
+        return ORANUMBER_INVALID_INTERNAL_FORMAT;
+    }
+    if (datalen == 1) {
+        if (on->OCINumberPart[1] == 0x80) {
+            /* zero */
+            p->sign = 0;
+            p->exponent = 0;
+            p->len = 0;
+            return ORANUMBER_SUCCESS;
+        }
+        /* negative infinity or unexpected format */
+        return ORANUMBER_INEXACT_RESULT;
+    }
+    if (datalen == 2 && on->OCINumberPart[1] == 255 && on->OCINumberPart[2] == 101) {
+        /* positive infinity */
+        return ORANUMBER_INEXACT_RESULT;
+    }
+    datalen--; /* number of base-100 digits */
+    if (on->OCINumberPart[1] >= 128) {
+        p->sign = 1;
+        p->exponent = on->OCINumberPart[1] - 193;
+    } else {
+        p->sign = -1;
+        p->exponent = 62 - on->OCINumberPart[1];
+        if (mantissa[datalen - 1] == 102) {
+            /* negative value's terminator */
+            datalen--;
+        }
+    }
+    for (idx = 0; idx < datalen; idx++) {
+        n = (p->sign > 0) ? (mantissa[idx] - 1) : (101 - mantissa[idx]);
+        if (n < 0 || 99 < n) {
+            return ORANUMBER_INVALID_INTERNAL_FORMAT;
+        }
+        p->digits[idx] = n;
+    }
+    p->len = datalen;
+    return ORANUMBER_SUCCESS;
+}
+
+static int oranumber_encode(OCINumber *on, const oranumber_parts_t *p)
+{
+    int start = 0;
+    int len = p->len;
+    int exponent = p->exponent;
+    int ndigits;
+    int idx;
+
+    /* strip leading and trailing zeros */
+    while (start < len && p->digits[start] == 0) {
+        start++;
+        exponent--;
+    }
+    while (len > start && p->digits[len - 1] == 0) {
+        len--;
+    }
+    if (start == len || p->sign == 0) {
+        /* zero */
+        on->OCINumberPart[0] = 1;
+        on->OCINumberPart[1] = 0x80;
+        return ORANUMBER_SUCCESS;
+    }
+    len -= start;
+    /* count significant decimal digits */
+    ndigits = len * 2;
+    if (p->digits[start] < 10) {
+        ndigits--;
+    }
+    if (p->digits[start + len - 1] % 10 == 0) {
+        ndigits--;
+    }
+    if (ndigits > 38 || exponent < -65 || 62 < exponent) {
+        return ORANUMBER_INEXACT_RESULT;
+    }
+    if (p->sign > 0) {
+        on->OCINumberPart[0] = len + 1;
+        on->OCINumberPart[1] = exponent + 193;
+        for (idx = 0; idx < len; idx++) {
+            on->OCINumberPart[idx + 2] = p->digits[start + idx] + 1;
+        }
+    } else {
+        on->OCINumberPart[1] = 62 - exponent;
+        for (idx = 0; idx < len; idx++) {
+            on->OCINumberPart[idx + 2] = 101 - p->digits[start + idx];
+        }
+        if (len < 20) {
+            /* negative value's terminator */
+            on->OCINumberPart[idx + 2] = 102;
+            len++;
+        }
+        on->OCINumberPart[0] = len + 1;
+    }
+    return ORANUMBER_SUCCESS;
+}
+
+int oranumber_from_int64(OCINumber *on, oranumber_int64 val)
+{
+    oranumber_parts_t p;
+    oranumber_uint64 uval = (val < 0) ? -(oranumber_uint64)val : (oranumber_uint64)val;
+    int buf[10]; /* from the least significant digit */
+    int n = 0;
+
+    while (uval != 0) {
+        buf[n++] = (int)(uval % 100);
+        uval /= 100;
+    }
+    p.sign = (val > 0) ? 1 : ((val < 0) ? -1 : 0);
+    p.exponent = n - 1;
+    for (p.len = 0; p.len < n; p.len++) {
+        p.digits[p.len] = buf[n - 1 - p.len];
+    }
+    return oranumber_encode(on, &p);
+}
+
+/* compares absolute values of nonzero numbers */
+static int oranumber_cmp_abs(const oranumber_parts_t *a, const oranumber_parts_t *b)
+{
+    int idx;
+
+    if (a->exponent != b->exponent) {
+        return (a->exponent > b->exponent) ? 1 : -1;
+    }
+    for (idx = 0; idx < a->len || idx < b->len; idx++) {
+        int x = (idx < a->len) ? a->digits[idx] : 0;
+        int y = (idx < b->len) ? b->digits[idx] : 0;
+        if (x != y) {
+            return (x > y) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/* r = a + b * b_sign */
+static int oranumber_add_parts(OCINumber *r, const oranumber_parts_t *a, const oranumber_parts_t *b, int b_sign)
+{
+    const oranumber_parts_t *x;
+    const oranumber_parts_t *y;
+    oranumber_parts_t result;
+    int top;
+    int bottom;
+    int span;
+    int idx;
+    int off;
+    int carry;
+
+    if (b->sign == 0) {
+        return oranumber_encode(r, a);
+    }
+    if (a->sign == 0) {
+        result = *b;
+        result.sign = b->sign * b_sign;
+        return oranumber_encode(r, &result);
+    }
+    /* x is the larger in magnitude. */
+    if (oranumber_cmp_abs(a, b) >= 0) {
+        x = a;
+        y = b;
+        result.sign = a->sign;
+    } else {
+        x = b;
+        y = a;
+        result.sign = b->sign * b_sign;
+    }
+    top = x->exponent;
+    bottom = x->exponent - x->len + 1;
+    if (bottom > y->exponent - y->len + 1) {
+        bottom = y->exponent - y->len + 1;
+    }
+    span = top - bottom + 1;
+    if (span + 1 > ORANUMBER_WORK_DIGITS) {
+        return ORANUMBER_INEXACT_RESULT;
+    }
+    /* digits[0] is for the carry. */
+    result.exponent = top + 1;
+    result.len = span + 1;
+    memset(result.digits, 0, sizeof(int) * result.len);
+    for (idx = 0; idx < x->len; idx++) {
+        result.digits[idx + 1] = x->digits[idx];
+    }
+    off = top - y->exponent + 1;
+    if (a->sign * b->sign * b_sign > 0) {
+        for (idx = 0; idx < y->len; idx++) {
+            result.digits[idx + off] += y->digits[idx];
+        }
+    } else {
+        for (idx = 0; idx < y->len; idx++) {
+            result.digits[idx + off] -= y->digits[idx];
+        }
+    }
+    carry = 0;
+    for (idx = result.len - 1; idx >= 0; idx--) {
+        int n = result.digits[idx] + carry;
+        if (n >= 100) {
+            result.digits[idx] = n - 100;
+            carry = 1;
+        } else if (n < 0) {
+            result.digits[idx] = n + 100;
+            carry = -1;
+        } else {
+            result.digits[idx] = n;
+            carry = 0;
+        }
+    }
+    return oranumber_encode(r, &result);
+}
+
+int oranumber_add(OCINumber *r, const OCINumber *a, const OCINumber *b)
+{
+    oranumber_parts_t x;
+    oranumber_parts_t y;
+    int rv;
+
+    if ((rv = oranumber_decode(a, &x)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    if ((rv = oranumber_decode(b, &y)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    return oranumber_add_parts(r, &x, &y, 1);
+}
+
+int oranumber_sub(OCINumber *r, const OCINumber *a, const OCINumber *b)
+{
+    oranumber_parts_t x;
+    oranumber_parts_t y;
+    int rv;
+
+    if ((rv = oranumber_decode(a, &x)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    if ((rv = oranumber_decode(b, &y)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    return oranumber_add_parts(r, &x, &y, -1);
+}
+
+int oranumber_mul(OCINumber *r, const OCINumber *a, const OCINumber *b)
+{
+    oranumber_parts_t x;
+    oranumber_parts_t y;
+    oranumber_parts_t result;
+    int i;
+    int j;
+    int carry;
+    int rv;
+
+    if ((rv = oranumber_decode(a, &x)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    if ((rv = oranumber_decode(b, &y)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    result.sign = x.sign * y.sign;
+    if (result.sign == 0) {
+        return oranumber_encode(r, &result);
+    }
+    /* digits[0] is for the carry. */
+    result.exponent = x.exponent + y.exponent + 1;
+    result.len = x.len + y.len;
+    memset(result.digits, 0, sizeof(int) * result.len);
+    for (i = 0; i < x.len; i++) {
+        for (j = 0; j < y.len; j++) {
+            result.digits[i + j + 1] += x.digits[i] * y.digits[j];
+        }
+    }
+    carry = 0;
+    for (i = result.len - 1; i >= 0; i--) {
+        int n = result.digits[i] + carry;
+        result.digits[i] = n % 100;
+        carry = n / 100;
+    }
+    return oranumber_encode(r, &result);
+}
+
+/*
+ * Compares two numbers by their internal format. Normalized numbers,
+ * including infinity, are ordered lexicographically by the bytes
+ * after the length byte. A negative number's terminator (102) makes
+ * it smaller than longer numbers sharing the same prefix.
+ */
+int oranumber_cmp(const OCINumber *a, const OCINumber *b, int *result)
+{
+    int alen = a->OCINumberPart[0];
+    int blen = b->OCINumberPart[0];
+    int rv;
+
+    if (alen == 0 || alen > 21 || blen == 0 || blen > 21) {
+        return ORANUMBER_INVALID_INTERNAL_FORMAT;
+    }
+    rv = memcmp(a->OCINumberPart + 1, b->OCINumberPart + 1, (alen < blen) ? alen : blen);
+    if (rv == 0) {
+        rv = alen - blen;
+    }
+    *result = (rv > 0) ? 1 : ((rv < 0) ? -1 : 0);
+    return ORANUMBER_SUCCESS;
+}
+
+int oranumber_neg(OCINumber *r, const OCINumber *a)
+{
+    oranumber_parts_t x;
+    int rv;
+
+    if ((rv = oranumber_decode(a, &x)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    x.sign = -x.sign;
+    return oranumber_encode(r, &x);
+}
+
+int oranumber_abs(OCINumber *r, const OCINumber *a)
+{
+    oranumber_parts_t x;
+    int rv;
+
+    if ((rv = oranumber_decode(a, &x)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    if (x.sign < 0) {
+        x.sign = 1;
+    }
+    return oranumber_encode(r, &x);
+}
+
+/*
+ * Rounds a number to decplace decimal places by mode, one of
+ * ORANUMBER_ROUND, ORANUMBER_TRUNC, ORANUMBER_FLOOR and ORANUMBER_CEIL.
+ * ORANUMBER_ROUND rounds half away from zero as OCINumberRound does.
+ */
+int oranumber_round(OCINumber *r, const OCINumber *a, int decplace, int mode)
+{
+    oranumber_parts_t x;
+    char dec[ORANUMBER_WORK_DIGITS * 2]; /* decimal digits */
+    int dec_exponent; /* decimal exponent of dec[0] */
+    int ndec;
+    int keep;
+    int discarded = 0;
+    int round_up;
+    int idx;
+    int rv;
+
+    if (decplace < -200 || 200 < decplace) {
+        return ORANUMBER_INEXACT_RESULT;
+    }
+    if ((rv = oranumber_decode(a, &x)) != ORANUMBER_SUCCESS) {
+        return rv;
+    }
+    if (x.sign == 0) {
+        return oranumber_encode(r, &x);
+    }
+    /* split base-100 digits to decimal digits. */
+    dec_exponent = x.exponent * 2 + 1;
+    ndec = x.len * 2;
+    for (idx = 0; idx < x.len; idx++) {
+        dec[idx * 2] = x.digits[idx] / 10;
+        dec[idx * 2 + 1] = x.digits[idx] % 10;
+    }
+    /* the number of digits at or above 10^-decplace */
+    keep = dec_exponent + decplace + 1;
+    if (keep >= ndec) {
+        return oranumber_encode(r, &x);
+    }
+    for (idx = (keep > 0) ? keep : 0; idx < ndec; idx++) {
+        if (dec[idx] != 0) {
+            discarded = 1;
+            break;
+        }
+    }
+    switch (mode) {
+    case ORANUMBER_ROUND:
+        round_up = (keep >= 0 && dec[keep] >= 5);
+        break;
+    case ORANUMBER_FLOOR:
+        round_up = (discarded && x.sign < 0);
+        break;
+    case ORANUMBER_CEIL:
+        round_up = (discarded && x.sign > 0);
+        break;
+    default:
+        round_up = 0;
+    }
+    if (keep <= 0) {
+        /* all digits are discarded. */
+        ndec = 0;
+        if (round_up) {
+            dec[0] = 1;
+            ndec = 1;
+            dec_exponent = -decplace;
+        }
+    } else {
+        ndec = keep;
+        if (round_up) {
+            for (idx = ndec - 1; idx >= 0; idx--) {
+                if (++dec[idx] != 10) {
+                    break;
+                }
+                dec[idx] = 0;
+            }
+            if (idx == -1) {
+                /* all digits are rounded up. */
+                dec[0] = 1;
+                ndec = 1;
+                dec_exponent++;
+            }
+        }
+    }
+    /* join decimal digits to base-100 digits. */
+    x.len = 0;
+    if (ndec > 0) {
+        int pos = 0;
+
+        if (dec_exponent >= 0) {
+            x.exponent = dec_exponent / 2;
+        } else {
+            x.exponent = -((1 - dec_exponent) / 2);
+        }
+        if (dec_exponent == x.exponent * 2) {
+            /* dec[0] is the units digit of a base-100 digit. */
+            x.digits[x.len++] = dec[pos++];
+        }
+        for (; pos < ndec; pos += 2) {
+            x.digits[x.len++] = dec[pos] * 10 + ((pos + 1 < ndec) ? dec[pos + 1] : 0);
+        }
+    }
+    return oranumber_encode(r, &x);
+}
+
 int oranumber_dump(const OCINumber *on, char *buf)
 {
     int idx;
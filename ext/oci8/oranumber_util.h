@@ -10,13 +10,40 @@
 
 #define ORANUMBER_INVALID_INTERNAL_FORMAT -1
 #define ORANUMBER_TOO_SHORT_BUFFER -2
+#define ORANUMBER_INEXACT_RESULT -3
 
 #define ORANUMBER_SUCCESS 0
 #define ORANUMBER_INVALID_NUMBER 1722
 #define ORANUMBER_NUMERIC_OVERFLOW 1426
 
+#ifdef _MSC_VER
+typedef __int64 oranumber_int64;
+typedef unsigned __int64 oranumber_uint64;
+#else
+typedef long long oranumber_int64;
+typedef unsigned long long oranumber_uint64;
+#endif
+
 int oranumber_to_str(const OCINumber *on, char *buf, int buflen);
 int oranumber_from_str(OCINumber *on, const char *buf, int buflen);
+int oranumber_from_mantissa(OCINumber *on, int is_positive, char *mantissa, int idx, long exponent);
+int oranumber_to_int64(const OCINumber *on, oranumber_int64 *out);
+int oranumber_to_double(const OCINumber *on, double *out);
+int oranumber_from_double(OCINumber *on, double dbl);
+int oranumber_from_int64(OCINumber *on, oranumber_int64 val);
+
+/* arithmetic which falls back to OCI by ORANUMBER_INEXACT_RESULT */
+#define ORANUMBER_ROUND 0
+#define ORANUMBER_TRUNC 1
+#define ORANUMBER_FLOOR 2
+#define ORANUMBER_CEIL  3
+int oranumber_add(OCINumber *r, const OCINumber *a, const OCINumber *b);
+int oranumber_sub(OCINumber *r, const OCINumber *a, const OCINumber *b);
+int oranumber_mul(OCINumber *r, const OCINumber *a, const OCINumber *b);
+int oranumber_cmp(const OCINumber *a, const OCINumber *b, int *result);
+int oranumber_neg(OCINumber *r, const OCINumber *a);
+int oranumber_abs(OCINumber *r, const OCINumber *a);
+int oranumber_round(OCINumber *r, const OCINumber *a, int decplace, int mode);
 
 #define ORANUMBER_DUMP_BUF_SIZ 99
 int oranumber_dump(const OCINumber *on, char *buf);
@@ -7,6 +7,17 @@
  *
  */
 #include "oci8.h"
+#include "oranumber_util.h"
+
+#ifndef OCI_ATTR_LOBPREFETCH_SIZE
+#define OCI_ATTR_LOBPREFETCH_SIZE 439
+#endif
+#ifndef OCI_ATTR_LOBPREFETCH_LENGTH
+#define OCI_ATTR_LOBPREFETCH_LENGTH 440
+#endif
+#ifndef SQLT_BDOUBLE
+#define SQLT_BDOUBLE 22
+#endif
 
 static VALUE oci8_sym_select_stmt;
 static VALUE oci8_sym_update_stmt;
@@ -17,6 +28,10 @@ static VALUE oci8_sym_drop_stmt;
 static VALUE oci8_sym_alter_stmt;
 static VALUE oci8_sym_begin_stmt;
 static VALUE oci8_sym_declare_stmt;
+static VALUE oci8_sym_sum;
+static VALUE oci8_sym_min;
+static VALUE oci8_sym_max;
+static VALUE oci8_sym_count;
 static ID id_at_column_metadata;
 static ID id_at_actual_array_size;
 static ID id_at_max_array_size;
@@ -27,6 +42,7 @@ static ID id_at_con;
 static ID id_clear;
 
 VALUE cOCIStmt;
+static VALUE cOCI8Row;
 
 #define TO_STMT(obj) ((oci8_stmt_t *)oci8_get_handle((obj), cOCIStmt))
 
@@ -35,6 +51,17 @@ typedef struct {
     VALUE svc;
     VALUE binds;
     VALUE defns;
+    /* rows fetched into define buffers by the last array fetch. */
+    ub4 num_rows;
+    /* index of the next row to be returned from define buffers. */
+    ub4 row_idx;
+    /* row count just after the last OCIStmtFetch. */
+    ub4 row_count;
+    int eof;
+    /* error of an array fetch raised after rows fetched before it. */
+    VALUE pending_exc;
+    /* LOB prefetch size set to CLOB and BLOB defines. zero disables it. */
+    ub4 lob_prefetch_size;
 } oci8_stmt_t;
 
 static void oci8_stmt_mark(oci8_base_t *base)
@@ -43,6 +70,7 @@ static void oci8_stmt_mark(oci8_base_t *base)
     rb_gc_mark(stmt->svc);
     rb_gc_mark(stmt->binds);
     rb_gc_mark(stmt->defns);
+    rb_gc_mark(stmt->pending_exc);
 }
 
 static void oci8_stmt_free(oci8_base_t *base)
@@ -51,6 +79,7 @@ static void oci8_stmt_free(oci8_base_t *base)
     stmt->svc = Qnil;
     stmt->binds = Qnil;
     stmt->defns = Qnil;
+    stmt->pending_exc = Qnil;
 }
 
 static oci8_base_class_t oci8_stmt_class = {
@@ -79,6 +108,12 @@ static VALUE oci8_stmt_initialize(int argc, VALUE *argv, VALUE self)
     stmt->svc = svc;
     stmt->binds = rb_hash_new();
     stmt->defns = rb_ary_new();
+    stmt->num_rows = 0;
+    stmt->row_idx = 0;
+    stmt->row_count = 0;
+    stmt->eof = 0;
+    stmt->pending_exc = Qnil;
+    stmt->lob_prefetch_size = 0;
     rb_ivar_set(stmt->base.self, id_at_column_metadata, rb_ary_new());
     rb_ivar_set(stmt->base.self, id_at_names, Qnil);
     rb_ivar_set(stmt->base.self, id_at_con, svc);
@@ -94,6 +129,18 @@ static VALUE oci8_stmt_initialize(int argc, VALUE *argv, VALUE self)
     return Qnil;
 }
 
+static void set_lob_prefetch(oci8_stmt_t *stmt, oci8_bind_t *obind)
+{
+    const oci8_bind_class_t *bind_class = (const oci8_bind_class_t *)obind->base.klass;
+    boolean prefetch_length = TRUE;
+
+    if (bind_class->dty != SQLT_CLOB && bind_class->dty != SQLT_BLOB) {
+        return;
+    }
+    oci_lc(OCIAttrSet(obind->base.hp.dfn, OCI_HTYPE_DEFINE, &stmt->lob_prefetch_size, 0, OCI_ATTR_LOBPREFETCH_SIZE, oci8_errhp));
+    oci_lc(OCIAttrSet(obind->base.hp.dfn, OCI_HTYPE_DEFINE, &prefetch_length, 0, OCI_ATTR_LOBPREFETCH_LENGTH, oci8_errhp));
+}
+
 static VALUE oci8_define_by_pos(VALUE self, VALUE vposition, VALUE vbindobj)
 {
     oci8_stmt_t *stmt = TO_STMT(self);
@@ -108,7 +155,15 @@ static VALUE oci8_define_by_pos(VALUE self, VALUE vposition, VALUE vbindobj)
         oci8_base_free(&obind->base); /* TODO: OK? */
     }
     bind_class = (const oci8_bind_class_t *)obind->base.klass;
-    status = OCIDefineByPos(stmt->base.hp.stmt, &obind->base.hp.dfn, oci8_errhp, position, obind->valuep, obind->value_sz, bind_class->dty, NIL_P(obind->tdo) ? obind->u.inds : NULL, NULL, 0, OCI_DEFAULT);
+    if (oci8_bind_string_is_dynamic(obind)) {
+        /* buffers are passed to OCI by callbacks. */
+        status = OCIDefineByPos(stmt->base.hp.stmt, &obind->base.hp.dfn, oci8_errhp, position, NULL, obind->value_sz, SQLT_CHR, NULL, NULL, 0, OCI_DYNAMIC_FETCH);
+        if (status == OCI_SUCCESS) {
+            status = oci8_bind_string_define_dynamic(obind);
+        }
+    } else {
+        status = OCIDefineByPos(stmt->base.hp.stmt, &obind->base.hp.dfn, oci8_errhp, position, obind->valuep, obind->value_sz, bind_class->dty, NIL_P(obind->tdo) ? obind->u.inds : NULL, NULL, 0, OCI_DEFAULT);
+    }
     if (status != OCI_SUCCESS) {
         oci8_raise(oci8_errhp, status, stmt->base.hp.ptr);
     }
@@ -117,12 +172,15 @@ static VALUE oci8_define_by_pos(VALUE self, VALUE vposition, VALUE vbindobj)
     oci8_unlink_from_parent((oci8_base_t*)obind);
     oci8_link_to_parent((oci8_base_t*)obind, (oci8_base_t*)stmt);
 
-    if (NIL_P(obind->tdo) && obind->maxar_sz > 0) {
+    if (NIL_P(obind->tdo) && obind->maxar_sz > 0 && !oci8_bind_string_is_dynamic(obind)) {
         oci_lc(OCIDefineArrayOfStruct(obind->base.hp.dfn, oci8_errhp, obind->alloc_sz, sizeof(sb2), 0, 0));
     }
     if (bind_class->post_bind_hook != NULL) {
         bind_class->post_bind_hook(obind);
     }
+    if (stmt->lob_prefetch_size > 0) {
+        set_lob_prefetch(stmt, obind);
+    }
     if (position - 1 < RARRAY_LEN(stmt->defns)) {
         VALUE old_value = RARRAY_PTR(stmt->defns)[position - 1];
         if (!NIL_P(old_value)) {
@@ -164,6 +222,9 @@ static VALUE oci8_bind(VALUE self, VALUE vplaceholder, VALUE vbindobj)
         placeholder_len = RSTRING_LEN(vplaceholder);
     }
     obind = oci8_get_bind(vbindobj); /* 2 */
+    if (oci8_bind_string_is_dynamic(obind)) {
+        rb_raise(rb_eArgError, "dynamic string defines cannot be bound");
+    }
     if (obind->base.hp.bnd != NULL) {
         oci8_base_free(&obind->base); /* TODO: OK? */
     }
@@ -241,6 +302,11 @@ static VALUE oci8_stmt_execute(VALUE self, VALUE iteration_count)
     if (IS_OCI_ERROR(rv)) {
         oci8_raise(oci8_errhp, rv, stmt->base.hp.stmt);
     }
+    stmt->num_rows = 0;
+    stmt->row_idx = 0;
+    stmt->row_count = 0;
+    stmt->eof = 0;
+    stmt->pending_exc = Qnil;
     return self;
 }
 
@@ -270,14 +336,76 @@ static VALUE oci8_stmt_clear_binds(VALUE self)
     return self;
 }
 
-static VALUE oci8_stmt_do_fetch(oci8_stmt_t *stmt, oci8_svcctx_t *svcctx)
+/*
+ * Returns the number of rows fetched at a time. It is the minimum
+ * array size of the defined columns. The array size of columns
+ * defined without max_array_size is regarded as one.
+ */
+static ub4 oci8_stmt_fetch_array_size(oci8_stmt_t *stmt)
 {
-    VALUE ary;
-    sword rv;
+    ub4 nrows = 0;
     long idx;
+
+    for (idx = 0; idx < RARRAY_LEN(stmt->defns); idx++) {
+        VALUE obj = RARRAY_PTR(stmt->defns)[idx];
+        ub4 sz;
+
+        if (NIL_P(obj)) {
+            continue;
+        }
+        sz = oci8_get_bind(obj)->maxar_sz;
+        if (sz == 0) {
+            return 1;
+        }
+        if (nrows == 0 || sz < nrows) {
+            nrows = sz;
+        }
+    }
+    return nrows ? nrows : 1;
+}
+
+typedef struct {
+    oci8_stmt_t *stmt;
+    sword rv;
+} fetch_error_arg_t;
+
+static VALUE fetch_error_raise(VALUE data)
+{
+    fetch_error_arg_t *arg = (fetch_error_arg_t *)data;
+    oci8_raise(oci8_errhp, arg->rv, arg->stmt->base.hp.stmt);
+    return Qnil;
+}
+
+static VALUE fetch_error_rescue(VALUE data, VALUE exc)
+{
+    return exc;
+}
+
+/*
+ * Fetches rows into define buffers if all rows in them were consumed.
+ * Returns zero when no more rows are available.
+ */
+static int oci8_stmt_fill_buffer(oci8_stmt_t *stmt, oci8_svcctx_t *svcctx)
+{
+    sword rv;
+    ub4 row_count;
+    ub4 array_size;
+    VALUE exc = Qnil;
     oci8_bind_t *obind;
     const oci8_bind_class_t *bind_class;
 
+    if (stmt->row_idx < stmt->num_rows) {
+        return 1;
+    }
+    /* all rows in define buffers are consumed. */
+    if (!NIL_P(stmt->pending_exc)) {
+        exc = stmt->pending_exc;
+        stmt->pending_exc = Qnil;
+        rb_exc_raise(exc);
+    }
+    if (stmt->eof) {
+        return 0;
+    }
     if (stmt->base.children != NULL) {
         obind = (oci8_bind_t *)stmt->base.children;
         do {
@@ -290,17 +418,49 @@ static VALUE oci8_stmt_do_fetch(oci8_stmt_t *stmt, oci8_svcctx_t *svcctx)
             obind = (oci8_bind_t *)obind->base.next;
         } while (obind != (oci8_bind_t*)stmt->base.children);
     }
-    rv = OCIStmtFetch_nb(svcctx, stmt->base.hp.stmt, oci8_errhp, 1, OCI_FETCH_NEXT, OCI_DEFAULT);
+    array_size = oci8_stmt_fetch_array_size(stmt);
+    rv = OCIStmtFetch_nb(svcctx, stmt->base.hp.stmt, oci8_errhp, array_size, OCI_FETCH_NEXT, OCI_DEFAULT);
     if (rv == OCI_NO_DATA) {
-        return Qnil;
+        stmt->eof = 1;
+    } else if (IS_OCI_ERROR(rv)) {
+        /* make the exception before oci8_errhp is used by OCIAttrGet. */
+        fetch_error_arg_t arg;
+        arg.stmt = stmt;
+        arg.rv = rv;
+        exc = rb_rescue2(fetch_error_raise, (VALUE)&arg, fetch_error_rescue, Qnil, eOCIException, (VALUE)0);
     }
-    if (IS_OCI_ERROR(rv)) {
-        oci8_raise(oci8_errhp, rv, stmt->base.hp.stmt);
+    /* OCI_ATTR_ROW_COUNT is the cumulative number of fetched rows,
+     * including rows fetched before an error. */
+    oci_lc(OCIAttrGet(stmt->base.hp.ptr, OCI_HTYPE_STMT, &row_count, 0, OCI_ATTR_ROW_COUNT, oci8_errhp));
+    stmt->num_rows = row_count - stmt->row_count;
+    if (stmt->num_rows > array_size) {
+        stmt->num_rows = array_size;
+    }
+    stmt->row_count = row_count;
+    stmt->row_idx = 0;
+    if (!NIL_P(exc)) {
+        if (stmt->num_rows == 0) {
+            rb_exc_raise(exc);
+        }
+        /* return rows fetched before the error first. */
+        stmt->pending_exc = exc;
+    }
+    return stmt->num_rows != 0;
+}
+
+static VALUE oci8_stmt_do_fetch(oci8_stmt_t *stmt, oci8_svcctx_t *svcctx)
+{
+    VALUE ary;
+    long idx;
+
+    if (!oci8_stmt_fill_buffer(stmt, svcctx)) {
+        return Qnil;
     }
     ary = rb_ary_new2(RARRAY_LEN(stmt->defns));
     for (idx = 0; idx < RARRAY_LEN(stmt->defns); idx++) {
-        rb_ary_store(ary, idx, oci8_bind_get_data(RARRAY_PTR(stmt->defns)[idx]));
+        rb_ary_store(ary, idx, oci8_bind_get_elem(RARRAY_PTR(stmt->defns)[idx], stmt->row_idx));
     }
+    stmt->row_idx++;
     return ary;
 }
 
@@ -334,6 +494,904 @@ static VALUE oci8_stmt_fetch(VALUE self)
     }
 }
 
+/*
+ * call-seq:
+ *   fetch_many(max_rows) -> array of rows or nil
+ *
+ * Fetches at most +max_rows+ rows and returns them as an array of
+ * arrays. Each element is same with the return value of
+ * OCI8::Cursor#fetch. It returns +nil+ when no more rows are
+ * available.
+ *
+ * Use it with OCI8::Cursor#fetch_array_size= to reduce network
+ * round trips.
+ *
+ * example:
+ *   cursor = conn.parse('SELECT * FROM emp')
+ *   cursor.fetch_array_size = 100
+ *   cursor.exec
+ *   while rows = cursor.fetch_many(100)
+ *     rows.each do |r|
+ *       puts r.join(',')
+ *     end
+ *   end
+ */
+static VALUE oci8_stmt_fetch_many(VALUE self, VALUE max_rows)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    oci8_svcctx_t *svcctx = oci8_get_svcctx(stmt->svc);
+    long nrows = NUM2LONG(max_rows);
+    long ncols = RARRAY_LEN(stmt->defns);
+    volatile VALUE rows;
+    long row;
+    long idx;
+
+    if (nrows <= 0) {
+        rb_raise(rb_eArgError, "expect positive number but %ld", nrows);
+    }
+    rows = rb_ary_new();
+    for (row = 0; row < nrows && oci8_stmt_fill_buffer(stmt, svcctx); row++) {
+        VALUE ary = rb_ary_new2(ncols);
+
+        for (idx = 0; idx < ncols; idx++) {
+            rb_ary_store(ary, idx, oci8_bind_get_elem(RARRAY_PTR(stmt->defns)[idx], stmt->row_idx));
+        }
+        stmt->row_idx++;
+        rb_ary_push(rows, ary);
+    }
+    return row == 0 ? Qnil : rows;
+}
+
+/*
+ * call-seq:
+ *   fetch_columns(max_rows) -> array of columns or nil
+ *
+ * Fetches at most +max_rows+ rows and returns them in column-major
+ * order: an array which has an array of values for each column
+ * in the select-list. It returns +nil+ when no more rows are
+ * available.
+ *
+ * example:
+ *   cursor = conn.exec('SELECT empno, sal FROM emp')
+ *   empnos, sals = cursor.fetch_columns(1000)
+ */
+static VALUE oci8_stmt_fetch_columns(VALUE self, VALUE max_rows)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    oci8_svcctx_t *svcctx = oci8_get_svcctx(stmt->svc);
+    long nrows = NUM2LONG(max_rows);
+    long ncols = RARRAY_LEN(stmt->defns);
+    volatile VALUE cols;
+    long row;
+    long idx;
+
+    if (nrows <= 0) {
+        rb_raise(rb_eArgError, "expect positive number but %ld", nrows);
+    }
+    cols = rb_ary_new2(ncols);
+    for (idx = 0; idx < ncols; idx++) {
+        rb_ary_store(cols, idx, rb_ary_new());
+    }
+    for (row = 0; row < nrows && oci8_stmt_fill_buffer(stmt, svcctx); row++) {
+        for (idx = 0; idx < ncols; idx++) {
+            rb_ary_push(RARRAY_PTR(cols)[idx], oci8_bind_get_elem(RARRAY_PTR(stmt->defns)[idx], stmt->row_idx));
+        }
+        stmt->row_idx++;
+    }
+    return row == 0 ? Qnil : cols;
+}
+
+/*
+ * Fetches a row as a hash whose keys are elements of +keys+.
+ * The keys are frozen by OCI8::Cursor#fetch_hash so that hashes
+ * share them without copies.
+ */
+static VALUE oci8_stmt_fetch_hash(VALUE self, VALUE keys)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    oci8_svcctx_t *svcctx = oci8_get_svcctx(stmt->svc);
+    long ncols = RARRAY_LEN(stmt->defns);
+    VALUE hash;
+    long idx;
+
+    Check_Type(keys, T_ARRAY);
+    if (RARRAY_LEN(keys) != ncols) {
+        rb_raise(rb_eArgError, "wrong number of keys (%ld for %ld)", RARRAY_LEN(keys), ncols);
+    }
+    if (!oci8_stmt_fill_buffer(stmt, svcctx)) {
+        return Qnil;
+    }
+#ifdef HAVE_RB_HASH_NEW_CAPA
+    hash = rb_hash_new_capa(ncols);
+#else
+    hash = rb_hash_new();
+#endif
+    for (idx = 0; idx < ncols; idx++) {
+        rb_hash_aset(hash, RARRAY_PTR(keys)[idx], oci8_bind_get_elem(RARRAY_PTR(stmt->defns)[idx], stmt->row_idx));
+    }
+    stmt->row_idx++;
+    return hash;
+}
+
+/*
+ * OCI8::Row
+ *
+ * A row fetched by OCI8::Cursor#fetch_row. Define buffer elements
+ * are copied to +buf+ and converted to ruby objects when they are
+ * accessed. Columns defined with descriptors or handles are
+ * converted at fetch because the copies would refer to them.
+ */
+typedef struct {
+    VALUE defns;   /* define objects */
+    VALUE columns; /* column name => index */
+    long ncols;
+    VALUE *values; /* Qundef until converted */
+    sb2 *inds;
+    long *offsets;
+    char *buf;
+} oci8_row_t;
+
+/* offsets of elements in oci8_row_t.buf are aligned to this. */
+#define ROW_ALIGN 8
+
+static void oci8_row_mark(oci8_row_t *row)
+{
+    long idx;
+
+    rb_gc_mark(row->defns);
+    rb_gc_mark(row->columns);
+    for (idx = 0; idx < row->ncols; idx++) {
+        if (row->values[idx] != Qundef) {
+            rb_gc_mark(row->values[idx]);
+        }
+    }
+}
+
+static void oci8_row_free(oci8_row_t *row)
+{
+    xfree(row->values);
+    xfree(row->inds);
+    xfree(row->offsets);
+    xfree(row->buf);
+    xfree(row);
+}
+
+static int row_is_lazy(const oci8_bind_t *obind)
+{
+    const oci8_bind_class_t *obc = (const oci8_bind_class_t *)obind->base.klass;
+
+    /* long values of dynamic defines aren't in the define buffer. */
+    return NIL_P(obind->tdo) && obc->init_elem == NULL && !oci8_bind_string_is_dynamic(obind);
+}
+
+/* the number of bytes used by the idx-th element of a define buffer */
+static long row_elem_size(const oci8_bind_t *obind, ub4 idx)
+{
+    const oci8_bind_class_t *obc = (const oci8_bind_class_t *)obind->base.klass;
+    const void *data = (const void *)((size_t)obind->valuep + obind->alloc_sz * idx);
+
+    if (oci8_bind_is_null(obind, idx)) {
+        return 0;
+    }
+    if (obc->dty == SQLT_LVC || obc->dty == SQLT_LVB) {
+        return offsetof(oci8_vstr_t, buf) + ((const oci8_vstr_t *)data)->size;
+    }
+    return obind->alloc_sz;
+}
+
+typedef struct {
+    VALUE obj;
+    oci8_bind_t *obind;
+    void *valuep;
+    sb2 *inds;
+    ub4 curar_idx;
+} row_get_arg_t;
+
+static VALUE row_get_elem(VALUE arg)
+{
+    return oci8_bind_get_elem(((row_get_arg_t *)arg)->obj, 0);
+}
+
+static VALUE row_restore_bind(VALUE arg)
+{
+    row_get_arg_t *rga = (row_get_arg_t *)arg;
+
+    rga->obind->valuep = rga->valuep;
+    rga->obind->u.inds = rga->inds;
+    rga->obind->curar_idx = rga->curar_idx;
+    return Qnil;
+}
+
+/*
+ * Converts the idx-th column. The define object's buffer is pointed
+ * to the copy temporarily so that +get+ overridden in ruby works.
+ */
+static VALUE row_value(oci8_row_t *row, long idx)
+{
+    row_get_arg_t rga;
+
+    if (row->values[idx] != Qundef) {
+        return row->values[idx];
+    }
+    rga.obj = RARRAY_PTR(row->defns)[idx];
+    rga.obind = oci8_get_bind(rga.obj);
+    rga.valuep = rga.obind->valuep;
+    rga.inds = rga.obind->u.inds;
+    rga.curar_idx = rga.obind->curar_idx;
+    rga.obind->valuep = row->buf + row->offsets[idx];
+    rga.obind->u.inds = &row->inds[idx];
+    row->values[idx] = rb_ensure(row_get_elem, (VALUE)&rga, row_restore_bind, (VALUE)&rga);
+    return row->values[idx];
+}
+
+/*
+ * Fetches a row as an OCI8::Row. +columns+ is a hash which maps
+ * column names to their indexes, shared by rows of the cursor.
+ */
+static VALUE oci8_stmt_fetch_row(VALUE self, VALUE columns)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    oci8_svcctx_t *svcctx = oci8_get_svcctx(stmt->svc);
+    long ncols = RARRAY_LEN(stmt->defns);
+    VALUE obj;
+    oci8_row_t *row;
+    long size = 0;
+    long idx;
+
+    Check_Type(columns, T_HASH);
+    if (!oci8_stmt_fill_buffer(stmt, svcctx)) {
+        return Qnil;
+    }
+    obj = Data_Make_Struct(cOCI8Row, oci8_row_t, oci8_row_mark, oci8_row_free, row);
+    row->defns = rb_ary_dup(stmt->defns);
+    row->columns = columns;
+    row->values = ALLOC_N(VALUE, ncols);
+    for (idx = 0; idx < ncols; idx++) {
+        row->values[idx] = Qnil;
+    }
+    row->ncols = ncols;
+    row->inds = ALLOC_N(sb2, ncols);
+    row->offsets = ALLOC_N(long, ncols);
+    for (idx = 0; idx < ncols; idx++) {
+        oci8_bind_t *obind = oci8_get_bind(RARRAY_PTR(stmt->defns)[idx]);
+
+        if (row_is_lazy(obind)) {
+            row->offsets[idx] = size;
+            size += (row_elem_size(obind, stmt->row_idx) + ROW_ALIGN - 1) / ROW_ALIGN * ROW_ALIGN;
+        } else {
+            row->offsets[idx] = -1;
+        }
+    }
+    row->buf = ALLOC_N(char, size ? size : 1);
+    for (idx = 0; idx < ncols; idx++) {
+        VALUE defn = RARRAY_PTR(stmt->defns)[idx];
+        oci8_bind_t *obind = oci8_get_bind(defn);
+
+        if (row->offsets[idx] >= 0) {
+            memcpy(row->buf + row->offsets[idx],
+                   (void *)((size_t)obind->valuep + obind->alloc_sz * stmt->row_idx),
+                   row_elem_size(obind, stmt->row_idx));
+            row->inds[idx] = obind->u.inds[stmt->row_idx];
+            row->values[idx] = Qundef;
+        } else {
+            row->values[idx] = oci8_bind_get_elem(defn, stmt->row_idx);
+        }
+    }
+    stmt->row_idx++;
+    return obj;
+}
+
+static oci8_row_t *row_get(VALUE self)
+{
+    oci8_row_t *row;
+
+    Data_Get_Struct(self, oci8_row_t, row);
+    return row;
+}
+
+/*
+ * call-seq:
+ *   row[index] -> value
+ *   row[name] -> value
+ *
+ * Returns the value of the column specified by +index+, which
+ * starts from zero, or by the column name as a String or a Symbol.
+ * The value is converted at the first access and cached. It returns
+ * +nil+ for unknown columns.
+ */
+static VALUE oci8_row_aref(VALUE self, VALUE key)
+{
+    oci8_row_t *row = row_get(self);
+    long idx;
+
+    if (FIXNUM_P(key)) {
+        idx = FIX2LONG(key);
+        if (idx < 0) {
+            idx += row->ncols;
+        }
+    } else {
+        VALUE pos = rb_hash_lookup(row->columns, key);
+
+        if (NIL_P(pos)) {
+            return Qnil;
+        }
+        idx = FIX2LONG(pos);
+    }
+    if (idx < 0 || row->ncols <= idx) {
+        return Qnil;
+    }
+    return row_value(row, idx);
+}
+
+/*
+ * call-seq:
+ *   to_a -> array
+ *
+ * Converts all columns and returns them as OCI8::Cursor#fetch does.
+ */
+static VALUE oci8_row_to_a(VALUE self)
+{
+    oci8_row_t *row = row_get(self);
+    VALUE ary = rb_ary_new2(row->ncols);
+    long idx;
+
+    for (idx = 0; idx < row->ncols; idx++) {
+        rb_ary_store(ary, idx, row_value(row, idx));
+    }
+    return ary;
+}
+
+static int row_to_h_i(VALUE key, VALUE pos, VALUE arg)
+{
+    VALUE *args = (VALUE *)arg;
+
+    if (TYPE(key) == T_STRING) {
+        rb_hash_aset(args[1], key, row_value(row_get(args[0]), FIX2LONG(pos)));
+    }
+    return ST_CONTINUE;
+}
+
+/*
+ * call-seq:
+ *   to_h -> hash
+ *
+ * Converts all columns and returns them as OCI8::Cursor#fetch_hash
+ * does.
+ */
+static VALUE oci8_row_to_h(VALUE self)
+{
+    VALUE args[2];
+
+    args[0] = self;
+    args[1] = rb_hash_new();
+    rb_hash_foreach(row_get(self)->columns, row_to_h_i, (VALUE)args);
+    return args[1];
+}
+
+/*
+ * call-seq:
+ *   size -> integer
+ *
+ * Returns the number of columns.
+ */
+static VALUE oci8_row_size(VALUE self)
+{
+    return LONG2NUM(row_get(self)->ncols);
+}
+
+/*
+ * call-seq:
+ *   string_dedup_stats -> array
+ *
+ * Returns statistics of the string cache enabled by
+ * OCI8::Cursor#string_dedup_size=. Each element corresponds to a
+ * column in the select-list: <tt>[hits, misses]</tt> for string
+ * columns and +nil+ for others.
+ *
+ * example:
+ *   cursor = conn.parse('SELECT status FROM orders')
+ *   cursor.string_dedup_size = 16
+ *   cursor.exec
+ *   cursor.fetch_many(100000)
+ *   cursor.string_dedup_stats # => [[99996, 4]]
+ */
+static VALUE oci8_stmt_string_dedup_stats(VALUE self)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    long ncols = RARRAY_LEN(stmt->defns);
+    VALUE ary = rb_ary_new2(ncols);
+    long idx;
+
+    for (idx = 0; idx < ncols; idx++) {
+        rb_ary_store(ary, idx, oci8_bind_string_dedup_stats(oci8_get_bind(RARRAY_PTR(stmt->defns)[idx])));
+    }
+    return ary;
+}
+
+/*
+ * call-seq:
+ *   define_bytes_allocated -> integer
+ *
+ * Returns the number of bytes allocated by ruby-oci8 for the define
+ * buffers of this cursor. It includes buffers allocated on demand for
+ * long values fetched by OCI8::Cursor#dynamic_string_size=.
+ *
+ * example:
+ *   cursor = conn.parse('SELECT description FROM items')
+ *   cursor.dynamic_string_size = 64
+ *   cursor.exec
+ *   cursor.fetch_many(1000)
+ *   cursor.define_bytes_allocated # => 13600
+ */
+static VALUE oci8_stmt_define_bytes_allocated(VALUE self)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    long ncols = RARRAY_LEN(stmt->defns);
+    size_t size = 0;
+    long idx;
+
+    for (idx = 0; idx < ncols; idx++) {
+        VALUE defn = RARRAY_PTR(stmt->defns)[idx];
+
+        if (!NIL_P(defn)) {
+            size += oci8_bind_bytes_allocated(oci8_get_bind(defn));
+        }
+    }
+    return ULONG2NUM((unsigned long)size);
+}
+
+/* aggregate functions of OCI8::Cursor#reduce_columns */
+enum {
+    AGG_NONE,
+    AGG_SUM,
+    AGG_MIN,
+    AGG_MAX,
+    AGG_COUNT
+};
+
+typedef struct {
+    int func;
+    ub2 dty;
+    long count; /* number of non-null values */
+    OCINumber onum;
+    double dbl;
+} oci8_agg_t;
+
+static int agg_func(VALUE sym)
+{
+    if (NIL_P(sym)) {
+        return AGG_NONE;
+    } else if (sym == oci8_sym_sum) {
+        return AGG_SUM;
+    } else if (sym == oci8_sym_min) {
+        return AGG_MIN;
+    } else if (sym == oci8_sym_max) {
+        return AGG_MAX;
+    } else if (sym == oci8_sym_count) {
+        return AGG_COUNT;
+    }
+    rb_raise(rb_eArgError, "unknown aggregate function %s", RSTRING_PTR(rb_inspect(sym)));
+}
+
+/* NUMBER columns: accumulated in base-100 digits. */
+static void agg_ocinumber(oci8_agg_t *agg, oci8_bind_t *obind, ub4 start, ub4 end)
+{
+    const OCINumber *data = (const OCINumber *)obind->valuep;
+    ub4 idx;
+    int cmp;
+
+    for (idx = start; idx < end; idx++) {
+        const OCINumber *on = (const OCINumber *)((size_t)data + obind->alloc_sz * idx);
+
+        if (obind->u.inds[idx] != 0) {
+            continue;
+        }
+        if (agg->count++ == 0) {
+            agg->onum = *on;
+            continue;
+        }
+        switch (agg->func) {
+        case AGG_SUM:
+            if (oranumber_add(&agg->onum, &agg->onum, on) != ORANUMBER_SUCCESS) {
+                oci_lc(OCINumberAdd(oci8_errhp, &agg->onum, on, &agg->onum));
+            }
+            break;
+        case AGG_MIN:
+        case AGG_MAX:
+            if (oranumber_cmp(on, &agg->onum, &cmp) != ORANUMBER_SUCCESS) {
+                sword rv;
+                oci_lc(OCINumberCmp(oci8_errhp, on, &agg->onum, &rv));
+                cmp = rv;
+            }
+            if ((agg->func == AGG_MIN) ? (cmp < 0) : (cmp > 0)) {
+                agg->onum = *on;
+            }
+            break;
+        }
+    }
+}
+
+/* BINARY_DOUBLE and BINARY_FLOAT columns */
+static void agg_double(oci8_agg_t *agg, oci8_bind_t *obind, ub4 start, ub4 end)
+{
+    const sb2 *inds = obind->u.inds;
+    double dbl = agg->dbl;
+    long count = agg->count;
+    ub4 idx;
+
+#define AGG_DOUBLE_AT(idx) (*(const double *)((size_t)obind->valuep + obind->alloc_sz * (idx)))
+    switch (agg->func) {
+    case AGG_SUM:
+        if (count == 0) {
+            dbl = 0.0;
+        }
+        for (idx = start; idx < end; idx++) {
+            if (inds[idx] == 0) {
+                dbl += AGG_DOUBLE_AT(idx);
+                count++;
+            }
+        }
+        break;
+    case AGG_MIN:
+        for (idx = start; idx < end; idx++) {
+            if (inds[idx] == 0 && (count++ == 0 || AGG_DOUBLE_AT(idx) < dbl)) {
+                dbl = AGG_DOUBLE_AT(idx);
+            }
+        }
+        break;
+    case AGG_MAX:
+        for (idx = start; idx < end; idx++) {
+            if (inds[idx] == 0 && (count++ == 0 || AGG_DOUBLE_AT(idx) > dbl)) {
+                dbl = AGG_DOUBLE_AT(idx);
+            }
+        }
+        break;
+    }
+#undef AGG_DOUBLE_AT
+    agg->dbl = dbl;
+    agg->count = count;
+}
+
+static void agg_count(oci8_agg_t *agg, oci8_bind_t *obind, ub4 start, ub4 end)
+{
+    ub4 idx;
+
+    for (idx = start; idx < end; idx++) {
+        if (NIL_P(obind->tdo)) {
+            if (obind->u.inds[idx] == 0) {
+                agg->count++;
+            }
+        } else {
+            if (*(OCIInd*)obind->u.null_structs[idx] == 0) {
+                agg->count++;
+            }
+        }
+    }
+}
+
+/*
+ * call-seq:
+ *   reduce_columns(*funcs) -> array
+ *
+ * Fetches all remaining rows and aggregates each column by the
+ * function specified at the same position: +:sum+, +:min+, +:max+,
+ * +:count+ or +nil+ to skip the column. NULL values are ignored.
+ *
+ * The values are read from define buffers by C functions without
+ * creating a ruby object per value. +:sum+, +:min+ and +:max+ are
+ * available for NUMBER, BINARY_DOUBLE and BINARY_FLOAT columns.
+ * Their results are converted as the column's fetched values are.
+ * They are +nil+ when all values are NULL. +:count+ returns the
+ * number of non-null values.
+ *
+ * Use it with OCI8::Cursor#fetch_array_size= to aggregate rows
+ * fetched by each round trip at once.
+ *
+ * example:
+ *   cursor = conn.parse('SELECT deptno, sal, comm FROM emp')
+ *   cursor.fetch_array_size = 1000
+ *   cursor.exec
+ *   nil_value, total_sal, comm_count = cursor.reduce_columns(nil, :sum, :count)
+ */
+static VALUE oci8_stmt_reduce_columns(int argc, VALUE *argv, VALUE self)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    oci8_svcctx_t *svcctx = oci8_get_svcctx(stmt->svc);
+    long ncols = RARRAY_LEN(stmt->defns);
+    oci8_agg_t *aggs;
+    volatile VALUE result;
+    long idx;
+
+    if (argc > ncols) {
+        rb_raise(rb_eArgError, "too many aggregate functions (%d for %ld)", argc, ncols);
+    }
+    aggs = ALLOCA_N(oci8_agg_t, argc);
+    for (idx = 0; idx < argc; idx++) {
+        VALUE obj = RARRAY_PTR(stmt->defns)[idx];
+
+        aggs[idx].func = agg_func(argv[idx]);
+        aggs[idx].count = 0;
+        if (aggs[idx].func == AGG_NONE || aggs[idx].func == AGG_COUNT) {
+            continue;
+        }
+        aggs[idx].dty = ((const oci8_bind_class_t *)oci8_get_bind(obj)->base.klass)->dty;
+        if ((aggs[idx].dty != SQLT_VNU && aggs[idx].dty != SQLT_BDOUBLE) || !NIL_P(oci8_get_bind(obj)->tdo)) {
+            rb_raise(rb_eTypeError, "column %ld isn't a numeric column", idx + 1);
+        }
+    }
+    while (oci8_stmt_fill_buffer(stmt, svcctx)) {
+        for (idx = 0; idx < argc; idx++) {
+            oci8_bind_t *obind = oci8_get_bind(RARRAY_PTR(stmt->defns)[idx]);
+
+            switch (aggs[idx].func) {
+            case AGG_NONE:
+                break;
+            case AGG_COUNT:
+                agg_count(&aggs[idx], obind, stmt->row_idx, stmt->num_rows);
+                break;
+            default:
+                if (aggs[idx].dty == SQLT_VNU) {
+                    agg_ocinumber(&aggs[idx], obind, stmt->row_idx, stmt->num_rows);
+                } else {
+                    agg_double(&aggs[idx], obind, stmt->row_idx, stmt->num_rows);
+                }
+            }
+        }
+        stmt->row_idx = stmt->num_rows;
+    }
+    result = rb_ary_new2(argc);
+    for (idx = 0; idx < argc; idx++) {
+        VALUE obj = RARRAY_PTR(stmt->defns)[idx];
+        oci8_bind_t *obind = oci8_get_bind(obj);
+
+        switch (aggs[idx].func) {
+        case AGG_NONE:
+            rb_ary_store(result, idx, Qnil);
+            break;
+        case AGG_COUNT:
+            rb_ary_store(result, idx, LONG2NUM(aggs[idx].count));
+            break;
+        default:
+            if (aggs[idx].count == 0) {
+                rb_ary_store(result, idx, Qnil);
+                break;
+            }
+            /* All rows were consumed. The first element of the define
+             * buffer is reused to convert the result as fetched values.
+             */
+            if (aggs[idx].dty == SQLT_VNU) {
+                *(OCINumber *)obind->valuep = aggs[idx].onum;
+            } else {
+                *(double *)obind->valuep = aggs[idx].dbl;
+            }
+            obind->u.inds[0] = 0;
+            rb_ary_store(result, idx, oci8_bind_get_elem(obj, 0));
+        }
+    }
+    return result;
+}
+
+/* a column packed by OCI8::Cursor#fetch_packed */
+typedef struct {
+    oci8_bind_t *obind;
+    int type; /* 'D' or 'q' */
+    VALUE data;
+    VALUE nulls;
+} oci8_packed_col_t;
+
+static char *packed_str_extend(VALUE str, long len)
+{
+    long oldlen = RSTRING_LEN(str);
+
+    rb_str_resize(str, oldlen + len);
+    return RSTRING_PTR(str) + oldlen;
+}
+
+/*
+ * Converts values of rows from +start+ to +end+ to packed 8-byte values
+ * in +out+. Values of NULL rows are zero. It raises an exception before
+ * the caller's strings are changed.
+ */
+static void packed_col_convert(oci8_packed_col_t *col, ub4 start, ub4 end, OCIError *errhp, char *out)
+{
+    oci8_bind_t *obind = col->obind;
+    int is_bdouble = ((const oci8_bind_class_t *)obind->base.klass)->dty == SQLT_BDOUBLE;
+    ub4 idx;
+
+    for (idx = start; idx < end; idx++, out += 8) {
+        void *data = (void *)((size_t)obind->valuep + obind->alloc_sz * idx);
+
+        if (obind->u.inds[idx] != 0) {
+            memset(out, 0, 8);
+            continue;
+        }
+        if (col->type == 'q') {
+            oranumber_int64 ival;
+
+            switch (oranumber_to_int64((const OCINumber *)data, &ival)) {
+            case ORANUMBER_SUCCESS:
+                break;
+            case ORANUMBER_NUMERIC_OVERFLOW:
+                rb_raise(rb_eRangeError, "fetched value exceeds 64-bit integer range");
+            default:
+                rb_raise(rb_eTypeError, "invalid internal number format");
+            }
+            memcpy(out, &ival, 8);
+        } else {
+            double dbl;
+
+            if (is_bdouble) {
+                dbl = *(double *)data;
+            } else {
+                dbl = oci8_onum_to_dbl((OCINumber *)data, errhp);
+            }
+            memcpy(out, &dbl, 8);
+        }
+    }
+}
+
+/* Appends values converted by packed_col_convert() and the null bitmap. */
+static void packed_col_append(oci8_packed_col_t *col, ub4 start, ub4 end, const char *values)
+{
+    oci8_bind_t *obind = col->obind;
+    long nrows = end - start;
+    long first_row = RSTRING_LEN(col->data) / 8;
+    ub4 idx;
+
+    memcpy(packed_str_extend(col->data, nrows * 8), values, nrows * 8);
+    if (!NIL_P(col->nulls)) {
+        long oldlen = RSTRING_LEN(col->nulls);
+        long newlen = (first_row + nrows + 7) / 8;
+        unsigned char *nulls;
+
+        if (newlen > oldlen) {
+            memset(packed_str_extend(col->nulls, newlen - oldlen), 0, newlen - oldlen);
+        }
+        nulls = (unsigned char *)RSTRING_PTR(col->nulls);
+        for (idx = start; idx < end; idx++) {
+            if (obind->u.inds[idx] != 0) {
+                long row = first_row + (idx - start);
+                nulls[row / 8] |= (unsigned char)(1 << (row % 8));
+            }
+        }
+    }
+}
+
+/*
+ * call-seq:
+ *   fetch_packed(max_rows, *buffers) -> number of rows or nil
+ *
+ * Fetches at most +max_rows+ rows and appends values of numeric
+ * columns to binary strings as packed native 8-byte values without
+ * creating a ruby object per value. It returns the number of fetched
+ * rows or +nil+ when no more rows are available.
+ *
+ * Each element of +buffers+ corresponds to a column in the
+ * select-list: +nil+ to skip the column, a string to which values
+ * are appended or an array of two strings. The second string of the
+ * array receives a null bitmap: bit <tt>n % 8</tt> of byte
+ * <tt>n / 8</tt> is set when the value of the <i>n</i>th row packed
+ * in the first string is NULL. Values of NULL rows are packed as
+ * zero.
+ *
+ * BINARY_DOUBLE and BINARY_FLOAT columns and NUMBER columns defined
+ * as OCI8::BindType::Float are packed as <tt>'D'</tt> of
+ * String#unpack. NUMBER columns defined as OCI8::BindType::Integer
+ * are packed as <tt>'q'</tt>. Use strings whose encoding is
+ * ASCII-8BIT.
+ *
+ * When a value cannot be packed, for example an integer which exceeds
+ * 64-bit range, RangeError is raised. Rows fetched by this call before
+ * the internal batch including the value are left appended, but no
+ * value of the batch is appended to any string and the next call
+ * starts from the first row of the batch again.
+ *
+ * example:
+ *   cursor = conn.parse('SELECT id, val FROM measurements')
+ *   cursor.define(1, Integer)
+ *   cursor.fetch_array_size = 1000
+ *   cursor.exec
+ *   ids = ''.force_encoding('ASCII-8BIT')
+ *   vals = ''.force_encoding('ASCII-8BIT')
+ *   val_nulls = ''.force_encoding('ASCII-8BIT')
+ *   while cursor.fetch_packed(1000, ids, [vals, val_nulls])
+ *   end
+ *   ids.unpack('q*')
+ */
+static VALUE oci8_stmt_fetch_packed(int argc, VALUE *argv, VALUE self)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    oci8_svcctx_t *svcctx = oci8_get_svcctx(stmt->svc);
+    long ncols = RARRAY_LEN(stmt->defns);
+    oci8_packed_col_t *cols;
+    OCIError *errhp = NULL;
+    volatile VALUE values = Qnil; /* values converted before appended */
+    long nrows;
+    long row = 0;
+    long idx;
+
+    if (argc < 1) {
+        rb_raise(rb_eArgError, "wrong number of arguments (%d for 1+)", argc);
+    }
+    nrows = NUM2LONG(argv[0]);
+    if (nrows <= 0) {
+        rb_raise(rb_eArgError, "expect positive number but %ld", nrows);
+    }
+    argc--;
+    argv++;
+    if (argc > ncols) {
+        rb_raise(rb_eArgError, "too many buffers (%d for %ld)", argc, ncols);
+    }
+    cols = ALLOCA_N(oci8_packed_col_t, argc);
+    for (idx = 0; idx < argc; idx++) {
+        VALUE buf = argv[idx];
+        oci8_bind_t *obind;
+
+        cols[idx].obind = NULL;
+        if (NIL_P(buf)) {
+            continue;
+        }
+        if (TYPE(buf) == T_ARRAY) {
+            if (RARRAY_LEN(buf) != 2) {
+                rb_raise(rb_eArgError, "expect [data, nulls] but %s", RSTRING_PTR(rb_inspect(buf)));
+            }
+            cols[idx].data = RARRAY_PTR(buf)[0];
+            cols[idx].nulls = RARRAY_PTR(buf)[1];
+            StringValue(cols[idx].nulls);
+            rb_str_modify(cols[idx].nulls);
+        } else {
+            cols[idx].data = buf;
+            cols[idx].nulls = Qnil;
+        }
+        StringValue(cols[idx].data);
+        rb_str_modify(cols[idx].data);
+        obind = oci8_get_bind(RARRAY_PTR(stmt->defns)[idx]);
+        if (!NIL_P(obind->tdo)) {
+            cols[idx].type = 0;
+        } else if (((const oci8_bind_class_t *)obind->base.klass)->dty == SQLT_BDOUBLE) {
+            cols[idx].type = 'D';
+        } else {
+            cols[idx].type = oci8_number_bind_pack_type(obind);
+        }
+        if (cols[idx].type == 0) {
+            rb_raise(rb_eTypeError, "column %ld isn't defined as Integer, Float or BinaryDouble", idx + 1);
+        }
+        if (cols[idx].type == 'D' && errhp == NULL) {
+            errhp = oci8_errhp;
+        }
+        cols[idx].obind = obind;
+    }
+    while (row < nrows && oci8_stmt_fill_buffer(stmt, svcctx)) {
+        ub4 start = stmt->row_idx;
+        ub4 end = stmt->num_rows;
+        long size;
+
+        if (end - start > (ub4)(nrows - row)) {
+            end = start + (ub4)(nrows - row);
+        }
+        /* convert all columns first not to append some of them on error. */
+        size = (long)(end - start) * 8;
+        if (NIL_P(values)) {
+            values = rb_str_new(NULL, size * argc);
+        } else {
+            rb_str_resize(values, size * argc);
+        }
+        for (idx = 0; idx < argc; idx++) {
+            if (cols[idx].obind != NULL) {
+                packed_col_convert(&cols[idx], start, end, errhp, RSTRING_PTR(values) + size * idx);
+            }
+        }
+        for (idx = 0; idx < argc; idx++) {
+            if (cols[idx].obind != NULL) {
+                packed_col_append(&cols[idx], start, end, RSTRING_PTR(values) + size * idx);
+            }
+        }
+        row += end - start;
+        stmt->row_idx = end;
+    }
+    return row == 0 ? Qnil : LONG2NUM(row);
+}
+
 static VALUE oci8_stmt_get_param(VALUE self, VALUE pos)
 {
     oci8_stmt_t *stmt = TO_STMT(self);
@@ -570,6 +1628,56 @@ static VALUE oci8_stmt_set_prefetch_rows(VALUE self, VALUE rows)
     return Qfalse;
 }
 
+/*
+ * call-seq:
+ *   lob_prefetch_size = size
+ *
+ * Sets the number of bytes (BLOB) or characters (CLOB and NCLOB)
+ * of LOB data fetched along with locators. The length and the chunk
+ * size are also prefetched. OCI8::LOB#size and OCI8::LOB#read of
+ * LOBs whose data fit in the prefetch size don't need extra round
+ * trips. Zero disables it.
+ *
+ * This is available on Oracle 11g client or upper.
+ *
+ * example:
+ *   cursor = conn.parse('SELECT id, comment_clob FROM comments')
+ *   cursor.lob_prefetch_size = 4000
+ *   cursor.exec
+ */
+static VALUE oci8_stmt_set_lob_prefetch_size(VALUE self, VALUE size)
+{
+    oci8_stmt_t *stmt = TO_STMT(self);
+    long idx;
+
+    if (oracle_client_version < ORAVER_11_1) {
+        rb_notimplement();
+    }
+    if (NUM2LONG(size) < 0) {
+        rb_raise(rb_eArgError, "expect zero or positive number for lob_prefetch_size.");
+    }
+    stmt->lob_prefetch_size = NUM2UINT(size);
+    /* apply to columns already defined. */
+    for (idx = 0; idx < RARRAY_LEN(stmt->defns); idx++) {
+        VALUE obj = RARRAY_PTR(stmt->defns)[idx];
+        if (!NIL_P(obj)) {
+            set_lob_prefetch(stmt, oci8_get_bind(obj));
+        }
+    }
+    return size;
+}
+
+/*
+ * call-seq:
+ *   lob_prefetch_size -> size
+ *
+ * See OCI8::Cursor#lob_prefetch_size=.
+ */
+static VALUE oci8_stmt_get_lob_prefetch_size(VALUE self)
+{
+    return UINT2NUM(TO_STMT(self)->lob_prefetch_size);
+}
+
 /*
  * bind_stmt
  */
@@ -632,6 +1740,13 @@ void Init_oci8_stmt(VALUE cOCI8)
     cOCIStmt = rb_define_class_under(cOCI8, "Cursor", cOCIHandle);
 #endif
     cOCIStmt = oci8_define_class_under(cOCI8, "Cursor", &oci8_stmt_class);
+    cOCI8Row = rb_define_class_under(cOCI8, "Row", rb_cObject);
+    rb_undef_alloc_func(cOCI8Row);
+    rb_define_method(cOCI8Row, "[]", oci8_row_aref, 1);
+    rb_define_method(cOCI8Row, "to_a", oci8_row_to_a, 0);
+    rb_define_method(cOCI8Row, "to_h", oci8_row_to_h, 0);
+    rb_define_method(cOCI8Row, "size", oci8_row_size, 0);
+    rb_define_method(cOCI8Row, "length", oci8_row_size, 0);
 
     oci8_sym_select_stmt = ID2SYM(rb_intern("select_stmt"));
     oci8_sym_update_stmt = ID2SYM(rb_intern("update_stmt"));
@@ -642,6 +1757,10 @@ void Init_oci8_stmt(VALUE cOCI8)
     oci8_sym_alter_stmt = ID2SYM(rb_intern("alter_stmt"));
     oci8_sym_begin_stmt = ID2SYM(rb_intern("begin_stmt"));
     oci8_sym_declare_stmt = ID2SYM(rb_intern("declare_stmt"));
+    oci8_sym_sum = ID2SYM(rb_intern("sum"));
+    oci8_sym_min = ID2SYM(rb_intern("min"));
+    oci8_sym_max = ID2SYM(rb_intern("max"));
+    oci8_sym_count = ID2SYM(rb_intern("count"));
     id_at_column_metadata = rb_intern("@column_metadata");
     id_at_actual_array_size = rb_intern("@actual_array_size");
     id_at_max_array_size = rb_intern("@max_array_size");
@@ -657,6 +1776,14 @@ void Init_oci8_stmt(VALUE cOCI8)
     rb_define_private_method(cOCIStmt, "__execute", oci8_stmt_execute, 1);
     rb_define_private_method(cOCIStmt, "__clearBinds", oci8_stmt_clear_binds, 0);
     rb_define_method(cOCIStmt, "fetch", oci8_stmt_fetch, 0);
+    rb_define_method(cOCIStmt, "fetch_many", oci8_stmt_fetch_many, 1);
+    rb_define_method(cOCIStmt, "fetch_columns", oci8_stmt_fetch_columns, 1);
+    rb_define_private_method(cOCIStmt, "__fetch_hash", oci8_stmt_fetch_hash, 1);
+    rb_define_private_method(cOCIStmt, "__fetch_row", oci8_stmt_fetch_row, 1);
+    rb_define_method(cOCIStmt, "string_dedup_stats", oci8_stmt_string_dedup_stats, 0);
+    rb_define_method(cOCIStmt, "define_bytes_allocated", oci8_stmt_define_bytes_allocated, 0);
+    rb_define_method(cOCIStmt, "reduce_columns", oci8_stmt_reduce_columns, -1);
+    rb_define_method(cOCIStmt, "fetch_packed", oci8_stmt_fetch_packed, -1);
     rb_define_private_method(cOCIStmt, "__paramGet", oci8_stmt_get_param, 1);
     rb_define_method(cOCIStmt, "type", oci8_stmt_get_stmt_type, 0);
     rb_define_method(cOCIStmt, "row_count", oci8_stmt_get_row_count, 0);
@@ -667,6 +1794,8 @@ void Init_oci8_stmt(VALUE cOCI8)
     rb_define_method(cOCIStmt, "keys", oci8_stmt_keys, 0);
     rb_define_private_method(cOCIStmt, "__defined?", oci8_stmt_defined_p, 1);
     rb_define_method(cOCIStmt, "prefetch_rows=", oci8_stmt_set_prefetch_rows, 1);
+    rb_define_method(cOCIStmt, "lob_prefetch_size=", oci8_stmt_set_lob_prefetch_size, 1);
+    rb_define_method(cOCIStmt, "lob_prefetch_size", oci8_stmt_get_lob_prefetch_size, 0);
 
     oci8_define_bind_class("Cursor", &bind_stmt_class);
 }
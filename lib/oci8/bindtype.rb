@@ -14,16 +14,6 @@ class OCI8
       end
     end
 
-    # get/set Date
-    class Date < OCI8::BindType::OraDate
-      def set(val)
-        super(val && ::OraDate.new(val.year, val.mon, val.mday))
-      end
-      def get()
-        (val = super()) && val.to_date
-      end
-    end
-
     class BigDecimal < OCI8::BindType::OraNumber
       @@bigdecimal_is_required = false
       def get()
@@ -46,12 +36,6 @@ class OCI8
       end
     end
 
-    class BasicNumberType < OCI8::BindType::OraNumber
-      def get()
-        (val = super()) && (val.has_decimal_part? ? val.to_f : val.to_i)
-      end
-    end
-
     # get/set Number (for OCI8::SQLT_NUM)
     class Number
       def self.create(con, val, param, max_array_size)
@@ -195,6 +179,36 @@ class OCI8
       end
     end
 
+    # Fetches a CLOB or NCLOB column as a String without a LOB locator.
+    # The value is truncated when it is longer than the define length,
+    # which is OCI8#long_read_len by default. The length is in bytes,
+    # so a truncated value may end with an incomplete character.
+    class CLOBAsString < OCI8::BindType::String
+      def self.create(con, val, param, max_array_size)
+        case param
+        when Hash
+          length = param[:length] || con.long_read_len
+          nchar = param[:nchar]
+        when OCI8::Metadata::Base
+          length = con.long_read_len
+          nchar = (param.charset_form == :nchar)
+        else
+          length = con.long_read_len
+        end
+        self.new(con, val, {:length => length, :length_semantics => :byte, :nchar => nchar, :truncate => true}, max_array_size)
+      end
+    end
+
+    # Fetches a BLOB column as a String without a LOB locator.
+    # The value is truncated when it is longer than the define length,
+    # which is OCI8#long_read_len by default.
+    class BLOBAsString < OCI8::BindType::RAW
+      def self.create(con, val, param, max_array_size)
+        length = param[:length] if param.is_a? Hash
+        self.new(con, val, {:length => length || con.long_read_len, :truncate => true}, max_array_size)
+      end
+    end
+
     class CLOB
       def self.create(con, val, param, max_array_size)
         if param.is_a? OCI8::Metadata::Base and param.charset_form == :nchar
@@ -269,6 +283,11 @@ OCI8::BindType::Mapping[:nclob] = OCI8::BindType::NCLOB
 # BLOB          SQLT_BLOB  4000    0    0
 OCI8::BindType::Mapping[:blob] = OCI8::BindType::BLOB
 
+# CLOB, NCLOB and BLOB fetched as String.
+# See OCI8::Cursor#lob_as_string_size=.
+OCI8::BindType::Mapping[:clob_as_string] = OCI8::BindType::CLOBAsString
+OCI8::BindType::Mapping[:blob_as_string] = OCI8::BindType::BLOBAsString
+
 # datatype        type     size prec scale
 # -------------------------------------------------
 # BFILE         SQLT_BFILE 4000    0    0
@@ -57,6 +57,12 @@ class OCI8
         @@default_timezone = tz
       end
 
+      # Returns true when fetched values of OCI8::BindType::Time are
+      # converted to Time in C. It is false prior to ruby 1.9.2.
+      def self.time_get_in_c?
+        @@time_new_accepts_timezone && defined?(OCI8::BindType::OCITimestampTZAsTime) ? true : false
+      end
+
       private
 
       def datetime_to_array(val, full)
@@ -361,15 +367,64 @@ class OCI8
     #  # or
     #  OCI8::BindType.default_timezone = :utc
     #
-    class Time < OCI8::BindType::OCITimestampTZ
+    class Time < (Util.time_get_in_c? ? OCI8::BindType::OCITimestampTZAsTime : OCI8::BindType::OCITimestampTZ)
       include OCI8::BindType::Util
 
       def set(val) # :nodoc:
         super(datetime_to_array(val, true))
       end
 
-      def get() # :nodoc:
-        ocitimestamp_to_time(super())
+      unless Util.time_get_in_c?
+        def get() # :nodoc:
+          ocitimestamp_to_time(super())
+        end
+      end
+    end
+
+    if defined? OCI8::BindType::OCIRawTimestamp
+      #--
+      # OCI8::BindType::RawTimestamp
+      #++
+      # This is a helper class to select or bind <tt>TIMESTAMP</tt> as
+      # a \Time. Unlike OCI8::BindType::Time, the values are fetched
+      # in Oracle's internal format and decoded in C. No OCIDateTime
+      # descriptor is allocated per fetch array element.
+      #
+      # The fetched values are in the local time zone of the client
+      # machine, not in the session time zone.
+      #
+      # To fetch <tt>TIMESTAMP</tt> columns by this class:
+      #
+      #   OCI8::BindType::Mapping[:timestamp] = OCI8::BindType::RawTimestamp
+      #
+      class RawTimestamp < OCI8::BindType::OCIRawTimestamp
+        include OCI8::BindType::Util
+
+        def set(val) # :nodoc:
+          super(datetime_to_array(val, true))
+        end
+      end
+
+      #--
+      # OCI8::BindType::RawTimestampTZ
+      #++
+      # This is a helper class to select or bind <tt>TIMESTAMP WITH
+      # TIME ZONE</tt> as a \Time in the same way with
+      # OCI8::BindType::RawTimestamp.
+      #
+      # The fetched values have their time zone offsets. Values whose
+      # time zone is a region name such as 'US/Pacific' are fetched
+      # in UTC because the region's offset isn't available without
+      # OCI calls.
+      #
+      #   OCI8::BindType::Mapping[:timestamp_tz] = OCI8::BindType::RawTimestampTZ
+      #
+      class RawTimestampTZ < OCI8::BindType::OCIRawTimestampTZ
+        include OCI8::BindType::Util
+
+        def set(val) # :nodoc:
+          super(datetime_to_array(val, true))
+        end
       end
     end
 
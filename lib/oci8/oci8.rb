@@ -135,6 +135,10 @@ class OCI8
 
     @prefetch_rows = nil
     @username = nil
+    @statement_cache = {}
+    @statement_cache_size = 0
+    @statement_cache_hits = 0
+    @statement_cache_misses = 0
   end
 
   # Executes the sql statement. The type of return value depends on
@@ -224,7 +228,7 @@ class OCI8
   #
   def exec(sql, *bindvars)
     begin
-      cursor = parse(sql)
+      cursor = checkout_cursor(sql)
       ret = cursor.exec(*bindvars)
       case cursor.type
       when :select_stmt
@@ -249,8 +253,12 @@ class OCI8
       else
         ret # number of rows processed
       end
-    ensure
+    rescue Exception
       cursor.nil? || cursor.close
+      cursor = nil
+      raise
+    ensure
+      cursor.nil? || checkin_cursor(sql, cursor)
     end
   end # exec
 
@@ -258,16 +266,76 @@ class OCI8
   #   select_one(sql, *bindvars) -> first_one_row
   #
   def select_one(sql, *bindvars)
-    cursor = self.parse(sql)
+    cursor = checkout_cursor(sql)
     begin
       cursor.exec(*bindvars)
       row = cursor.fetch
-    ensure
+    rescue Exception
       cursor.close
+      cursor = nil
+      raise
+    ensure
+      cursor.nil? || checkin_cursor(sql, cursor)
     end
     return row
   end
 
+  # call-seq:
+  #   statement_cache_size = size
+  #
+  # Sets the number of cursors cached by OCI8#exec and OCI8#select_one.
+  #
+  # When it is positive, a cursor used by them is kept in the connection
+  # after execution and reused when the same SQL text is executed
+  # again. It skips parsing the statement and allocating the cursor and
+  # its define handles. The least recently used cursor is closed when
+  # the number of cached cursors exceeds +size+.
+  #
+  # The default value is zero, which disables the cache. Cursors
+  # returned by OCI8#exec for select statements without a block and
+  # ones created by OCI8#parse aren't cached.
+  #
+  # example:
+  #   conn.statement_cache_size = 200
+  #   1000.times do |i|
+  #     conn.exec('INSERT INTO test_table VALUES (:1)', i) # parsed only once
+  #   end
+  #   conn.statement_cache_hits   # => 999
+  #   conn.statement_cache_misses # => 1
+  def statement_cache_size=(size)
+    size = size.to_i
+    raise ArgumentError, "expect zero or positive number for statement_cache_size." if size < 0
+    @statement_cache_size = size
+    trim_statement_cache
+    size
+  end
+
+  # call-seq:
+  #   statement_cache_size -> size
+  #
+  # Returns the maximum number of cursors cached by the connection.
+  # See OCI8#statement_cache_size=.
+  def statement_cache_size
+    @statement_cache_size
+  end
+
+  # call-seq:
+  #   statement_cache_hits -> count
+  #
+  # Returns the number of times a cached cursor was reused.
+  def statement_cache_hits
+    @statement_cache_hits
+  end
+
+  # call-seq:
+  #   statement_cache_misses -> count
+  #
+  # Returns the number of times a cursor was parsed because it wasn't
+  # in the statement cache. It isn't counted when the cache is disabled.
+  def statement_cache_misses
+    @statement_cache_misses
+  end
+
   def username
     @username || begin
       exec('select user from dual') do |row|
@@ -324,7 +392,10 @@ class OCI8
     #   cursor.define(2, Time)       # fetch the second column as Time.
     #   cursor.exec()
     def define(pos, type, length = nil)
-      __define(pos, make_bind_object(:type => type, :length => length))
+      max_array_size = @fetch_array_size
+      # named types don't support array fetch.
+      max_array_size = nil if type.is_a?(Class) && type < OCI8::Object::Base
+      __define(pos, setup_string_define(make_bind_object(:type => type, :length => length, :max_array_size => max_array_size)))
       self
     end # define
 
@@ -377,7 +448,9 @@ class OCI8
       else
         param = {:value => param, :type => type,  :length => length}
       end
-      __bind(key, make_bind_object(param))
+      bindobj = make_bind_object(param)
+      __bind(key, bindobj)
+      (@bind_classes ||= {})[key] = bindobj.class
       self
     end # bind_param
 
@@ -415,6 +488,7 @@ class OCI8
     def max_array_size=(size)
       raise "expect positive number for max_array_size." if size.nil? && size <=0
       __clearBinds if !@max_array_size.nil?
+      @bind_classes = nil
       @max_array_size = size
       @actual_array_size = nil
     end # max_array_size=
@@ -484,6 +558,124 @@ class OCI8
       end
     end # exec_array
 
+    # call-seq:
+    #   fetch_array_size = rows
+    #
+    # Sets the number of rows fetched by one round trip. Each column
+    # is defined as an array of +rows+ elements and OCI8::Cursor#fetch
+    # returns rows from the arrays until they are consumed.
+    # Set it before calling OCI8::Cursor#exec or OCI8::Cursor#define.
+    # +nil+ (default) fetches one row at a time.
+    #
+    # example:
+    #   cursor = conn.parse('SELECT * FROM emp')
+    #   cursor.fetch_array_size = 100
+    #   cursor.exec
+    #   while r = cursor.fetch
+    #     puts r.join(',')
+    #   end
+    def fetch_array_size=(rows)
+      raise ArgumentError, "expect positive number for fetch_array_size." if !rows.nil? && rows <= 0
+      @fetch_array_size = rows
+    end # fetch_array_size=
+
+    # call-seq:
+    #   lob_as_string_size = bytes
+    #
+    # Fetches CLOB, NCLOB and BLOB columns as String instead of
+    # OCI8::LOB. Values are defined as buffers of +bytes+ and longer
+    # values are truncated. No LOB locators are allocated and no extra
+    # round trips are needed to read the values. Set it before
+    # OCI8::Cursor#exec. +nil+ (default) fetches them as OCI8::LOB.
+    #
+    # example:
+    #   cursor = conn.parse('SELECT id, comment_clob FROM comments')
+    #   cursor.lob_as_string_size = 8000
+    #   cursor.exec
+    #   cursor.fetch # => [1, 'comment text']
+    def lob_as_string_size=(bytes)
+      raise ArgumentError, "expect positive number for lob_as_string_size." if !bytes.nil? && bytes <= 0
+      @lob_as_string_size = bytes
+    end # lob_as_string_size=
+
+    # call-seq:
+    #   lob_as_string_size -> bytes or nil
+    #
+    # See OCI8::Cursor#lob_as_string_size=.
+    def lob_as_string_size
+      @lob_as_string_size
+    end # lob_as_string_size
+
+    # call-seq:
+    #   string_dedup_size = entries
+    #
+    # Caches fetched values of string columns so that repeated values
+    # are returned as the same frozen String. Each column has its own
+    # cache of about +entries+ values. When a new value takes the
+    # place of another one in the cache, the old one is evicted. Set
+    # it before OCI8::Cursor#exec or OCI8::Cursor#define. +nil+
+    # (default) creates a new String for each value.
+    #
+    # It fits low-cardinality columns such as status or currency
+    # codes. See OCI8::Cursor#string_dedup_stats for hit counts.
+    #
+    # example:
+    #   cursor = conn.parse('SELECT id, status, currency FROM orders')
+    #   cursor.string_dedup_size = 16
+    #   cursor.exec
+    def string_dedup_size=(entries)
+      raise ArgumentError, "expect positive number for string_dedup_size." if !entries.nil? && entries <= 0
+      @string_dedup_size = entries
+    end # string_dedup_size=
+
+    # call-seq:
+    #   string_dedup_size -> entries or nil
+    #
+    # See OCI8::Cursor#string_dedup_size=.
+    def string_dedup_size
+      @string_dedup_size
+    end # string_dedup_size
+
+    # call-seq:
+    #   dynamic_string_size = bytes
+    #
+    # Fetches string columns to buffers of +bytes+ per row instead of
+    # buffers of the maximum column length. Longer values are fetched
+    # to buffers allocated on demand, which are reused by later
+    # fetches. Set it before OCI8::Cursor#exec or OCI8::Cursor#define.
+    # +nil+ (default) allocates buffers of the maximum length.
+    #
+    # It reduces memory usage of array fetch from wide columns such as
+    # VARCHAR2(4000) whose values are usually short. See
+    # OCI8::Cursor#define_bytes_allocated for the allocated size.
+    #
+    # example:
+    #   cursor = conn.parse('SELECT id, description FROM items')
+    #   cursor.fetch_array_size = 1000
+    #   cursor.dynamic_string_size = 64
+    #   cursor.exec
+    def dynamic_string_size=(bytes)
+      raise ArgumentError, "expect positive number for dynamic_string_size." if !bytes.nil? && bytes <= 0
+      @dynamic_string_size = bytes
+    end # dynamic_string_size=
+
+    # call-seq:
+    #   dynamic_string_size -> bytes or nil
+    #
+    # See OCI8::Cursor#dynamic_string_size=.
+    def dynamic_string_size
+      @dynamic_string_size
+    end # dynamic_string_size
+
+    # call-seq:
+    #   fetch_array_size -> rows or nil
+    #
+    # Returns the number of rows fetched by one round trip.
+    # See OCI8::Cursor#fetch_array_size=.
+    def fetch_array_size
+      @fetch_array_size
+    end # fetch_array_size
+
     # Gets the names of select-list as array. Please use this
     # method after exec.
     def get_col_names
@@ -511,24 +703,80 @@ class OCI8
     end
 
     # call-seq:
-    #   fetch_hash
+    #   fetch_hash(opts = {})
     #
     # get fetched data as a Hash. The hash keys are column names.
     # If a block is given, acts as an iterator.
-    def fetch_hash
+    #
+    # The keys are frozen strings created once per cursor and shared
+    # by all fetched hashes. When <tt>:symbolize_keys => true</tt> is
+    # given, the keys are symbols.
+    #
+    # example:
+    #   cursor = conn.exec('SELECT empno, ename FROM emp')
+    #   cursor.fetch_hash(:symbolize_keys => true) # => {:EMPNO => 7369, :ENAME => 'SMITH'}
+    def fetch_hash(opts = {})
+      keys = hash_keys(opts[:symbolize_keys])
       if iterator?
-        while ret = fetch_a_hash_row()
+        while ret = __fetch_hash(keys)
           yield(ret)
         end
       else
-        fetch_a_hash_row
+        __fetch_hash(keys)
       end
     end # fetch_hash
 
+    # call-seq:
+    #   fetch_row -> an OCI8::Row or nil
+    #
+    # Fetches a row as an OCI8::Row, which keeps a copy of the fetched
+    # data and converts a column to a ruby object when it is accessed
+    # by <tt>row[index]</tt>, <tt>row['NAME']</tt> or <tt>row[:NAME]</tt>.
+    # Converted values are cached. It returns +nil+ when no more rows
+    # are available.
+    #
+    # Use it for wide select-lists whose columns are partly used.
+    # Columns fetched as OCI8::LOB, OCI8::Cursor, named types and
+    # types using OCIDateTime or OCIInterval descriptors are converted
+    # at fetch.
+    #
+    # example:
+    #   cursor = conn.exec('SELECT * FROM wide_table')
+    #   while row = cursor.fetch_row
+    #     puts row[0], row['NAME'], row[:STATUS]
+    #   end
+    def fetch_row
+      __fetch_row(row_columns)
+    end # fetch_row
+
+    # call-seq:
+    #   aggregate(pos, func) -> value
+    #
+    # Fetches all remaining rows and returns the aggregate of the
+    # column at +pos+, which starts from 1. +func+ is one of +:sum+,
+    # +:min+, +:max+ and +:count+. See OCI8::Cursor#reduce_columns.
+    #
+    # example:
+    #   cursor = conn.parse('SELECT amount FROM ledger')
+    #   cursor.fetch_array_size = 1000
+    #   cursor.exec
+    #   total = cursor.aggregate(1, :sum)
+    def aggregate(pos, func)
+      ncols = @column_metadata.size
+      if !pos.is_a?(Integer) or pos < 1 or pos > ncols
+        raise ArgumentError, "column position #{pos.inspect} out of range (1..#{ncols})"
+      end
+      funcs = Array.new(pos)
+      funcs[pos - 1] = func
+      reduce_columns(*funcs)[pos - 1]
+    end # aggregate
+
     # close the cursor.
     def close
       free()
       @names = nil
+      @hash_keys = nil
+      @row_columns = nil
       @column_metadata = nil
     end # close
 
@@ -556,12 +804,16 @@ class OCI8
         end
       when OCI8::Metadata::Base
         key = param.data_type
+        max_array_size = @fetch_array_size
         case key
         when :named_type
           if param.type_name == 'XMLTYPE'
             key = :xmltype
           else
             param = @con.get_tdo_by_metadata(param.type_metadata)
+            # named types are defined by OCIDefineObject, which
+            # doesn't support array fetch.
+            max_array_size = nil
           end
         end
       else
@@ -579,6 +831,9 @@ class OCI8
 
     def define_columns
       num_cols = __param_count
+      # When the cursor is executed again, the select-list is same with
+      # the previous one. Reuse the column metadata and define handles.
+      return num_cols if @column_metadata.size == num_cols and columns_defined?(num_cols)
       1.upto(num_cols) do |i|
         parm = __paramGet(i)
         define_one_column(i, parm) unless __defined?(i)
@@ -587,33 +842,118 @@ class OCI8
       num_cols
     end # define_columns
 
+    def columns_defined?(num_cols)
+      1.upto(num_cols) do |i|
+        return false unless __defined?(i)
+      end
+      true
+    end # columns_defined?
+
     def define_one_column(pos, param)
-      __define(pos, make_bind_object(param))
+      if @lob_as_string_size
+        case param.data_type
+        when :clob, :nclob
+          bindobj = OCI8::BindType::CLOBAsString.create(@con, nil, {:length => @lob_as_string_size, :nchar => (param.charset_form == :nchar)}, @fetch_array_size)
+        when :blob
+          bindobj = OCI8::BindType::BLOBAsString.create(@con, nil, {:length => @lob_as_string_size}, @fetch_array_size)
+        end
+      end
+      __define(pos, setup_string_define(bindobj || make_bind_object(param)))
     end # define_one_column
 
+    def setup_string_define(bindobj)
+      if @string_dedup_size and bindobj.is_a? OCI8::BindType::String
+        bindobj.send(:__set_dedup_size, @string_dedup_size)
+      end
+      if @dynamic_string_size and bindobj.instance_of? OCI8::BindType::String
+        bindobj.send(:__set_dynamic_size, @dynamic_string_size)
+      end
+      bindobj
+    end # setup_string_define
+
     def bind_params(*bindvars)
       bindvars.each_with_index do |val, i|
 	if val.is_a? Array
 	  bind_param(i + 1, val[0], val[1], val[2])
-	else
+	elsif !reuse_bind_object(i + 1, val)
 	  bind_param(i + 1, val)
 	end
       end
     end # bind_params
 
-    def fetch_a_hash_row
-      if rs = fetch()
-        ret = {}
-        get_col_names.each do |name|
-          ret[name] = rs.shift
-        end
-        ret
-      else 
-        nil
+    # Sets +val+ to the bind object already bound at +key+ if its
+    # type is same with that of +val+. This is the case when a cursor
+    # is executed repeatedly by OCI8#exec with the statement cache.
+    def reuse_bind_object(key, val)
+      return false if @bind_classes.nil? or val.nil?
+      klass = @bind_classes[key]
+      return false if klass.nil? or klass != OCI8::BindType::Mapping[val.class]
+      begin
+        self[key] = val
+      rescue ArgumentError
+        # The bind object is too short to store val.
+        return false
       end
-    end # fetch_a_hash_row
+      true
+    end # reuse_bind_object
+
+    def hash_keys(symbolize)
+      @hash_keys ||= {}
+      @hash_keys[symbolize ? true : false] ||= if symbolize
+                                                 get_col_names.collect { |name| name.intern }.freeze
+                                               else
+                                                 get_col_names.collect { |name| name.dup.freeze }.freeze
+                                               end
+    end # hash_keys
+
+    def row_columns
+      @row_columns ||= begin
+                         columns = {}
+                         hash_keys(false).each_with_index do |name, idx|
+                           columns[name] = idx
+                           columns[name.intern] = idx
+                         end
+                         columns.freeze
+                       end
+    end # row_columns
 
   end # OCI8::Cursor
+
+  private
+
+  # Gets a cursor for +sql+ from the statement cache or parses it.
+  # The cursor is removed from the cache while it is used.
+  def checkout_cursor(sql)
+    return parse(sql) if @statement_cache_size == 0
+    if cursor = @statement_cache.delete(sql)
+      @statement_cache_hits += 1
+      cursor
+    else
+      @statement_cache_misses += 1
+      parse(sql)
+    end
+  end
+
+  # Puts back a cursor got by checkout_cursor to the statement cache.
+  def checkin_cursor(sql, cursor)
+    if @statement_cache_size == 0 or @statement_cache.has_key? sql
+      cursor.close
+    else
+      @statement_cache[sql] = cursor
+      trim_statement_cache
+    end
+  end
+
+  # Closes least recently used cursors until the number of cached
+  # cursors fits within statement_cache_size. Cursors are removed
+  # while they are used, so the insertion order of the hash is the
+  # order of use.
+  def trim_statement_cache
+    while @statement_cache.size > @statement_cache_size
+      sql, cursor = @statement_cache.shift
+      cursor.close
+    end
+  end
 end # OCI8
 
 class OraDate
@@ -0,0 +1,33 @@
+# Micro-benchmark of conversions between OraNumber and Integer/BigDecimal.
+# It prints the elapsed time and the number of objects allocated per
+# conversion. This isn't run by test_all.rb.
+#
+#   ruby -I../lib -I../ext/oci8 bench_oranumber.rb [count]
+#
+require 'oci8'
+require 'bigdecimal'
+require 'benchmark'
+
+count = (ARGV[0] || 100000).to_i
+
+bignum = 12345678901234567890123456789012345678
+bigdec = BigDecimal('1234567890123456789012345678.9012345678') # NUMBER(38,10)
+onum_bignum = OraNumber.new(bignum)
+onum_bigdec = OraNumber.new(bigdec)
+
+def allocated_objects
+  GC.stat(:total_allocated_objects)
+end
+
+[
+ ['OraNumber.new(Bignum)', proc { OraNumber.new(bignum) }],
+ ['OraNumber#to_i (Bignum)', proc { onum_bignum.to_i }],
+ ['OraNumber.new(BigDecimal)', proc { OraNumber.new(bigdec) }],
+ ['OraNumber#to_d', proc { onum_bigdec.to_d }],
+].each do |label, blk|
+  blk.call # warm up
+  objs = allocated_objects
+  time = Benchmark.realtime { count.times(&blk) }
+  objs = allocated_objects - objs
+  printf("%-26s %8.3f sec  %6.2f objects/conversion\n", label, time, objs.to_f / count)
+end
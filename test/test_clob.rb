@@ -75,6 +75,134 @@ class TestCLob < Test::Unit::TestCase
     lob.close
   end
 
+  def test_read_with_outbuf
+    test_insert() # first insert data.
+    filename = File.basename($lobfile)
+    cursor = @conn.exec("SELECT content FROM test_table WHERE filename = :1 FOR UPDATE", filename)
+    lob = cursor.fetch[0]
+
+    outbuf = ''
+    open($lobfile) do |f|
+      while buf = lob.read($lobreadnum, outbuf)
+        assert_same(outbuf, buf)
+        fbuf = f.read(buf.size)
+        assert_equal(fbuf, buf)
+      end
+      assert_equal('', outbuf)
+      assert(f.eof?)
+    end
+    lob.rewind
+    assert_equal(File.read($lobfile), lob.read(nil, outbuf))
+    lob.close
+  end
+
+  def test_write_stream
+    filename = File.basename($lobfile)
+    @conn.exec("DELETE FROM test_table WHERE filename = :1", filename)
+    @conn.exec("INSERT INTO test_table(filename, content) VALUES (:1, EMPTY_CLOB())", filename)
+    cursor = @conn.exec("SELECT content FROM test_table WHERE filename = :1 FOR UPDATE", filename)
+    lob = cursor.fetch[0]
+    content = File.read($lobfile)
+    open($lobfile) do |f|
+      lob.write_stream(f)
+    end
+    lob << 'END'
+    lob.rewind
+    assert_equal(content + 'END', lob.read)
+    lob.close
+  end
+
+  # an IO-like object which returns a new String without using outbuf.
+  class PieceReader
+    def initialize(data, error = nil)
+      @data = data
+      @error = error
+      @pos = 0
+    end
+
+    def read(length, outbuf = nil)
+      raise @error if @error and @pos >= @data.bytesize / 2
+      return nil if @pos >= @data.bytesize
+      str = @data.byteslice(@pos, length)
+      @pos += length
+      str
+    end
+  end
+
+  def test_write_stream_io_like
+    @conn.exec("INSERT INTO test_table(filename, content) VALUES ('stream', EMPTY_CLOB())")
+    cursor = @conn.exec("SELECT content FROM test_table WHERE filename = 'stream' FOR UPDATE")
+    lob = cursor.fetch[0]
+    # multibyte characters are split between reads.
+    content = (OCI8.encoding.name == 'UTF-8') ? "a\u3042" * 20000 : 'ab' * 20000
+    lob.write_stream(PieceReader.new(content))
+    lob.rewind
+    assert_equal(content, lob.read)
+
+    # an error in the middle of writing doesn't break the session.
+    lob.rewind
+    assert_raise(IOError) do
+      lob.write_stream(PieceReader.new(content, IOError))
+    end
+    assert_equal(['X'], @conn.select_one('SELECT * FROM DUAL'))
+    lob.close
+    cursor.close
+  end
+
+  def test_cached_size
+    @conn.exec("INSERT INTO test_table(filename, content) VALUES ('size', EMPTY_CLOB())")
+    cursor = @conn.exec("SELECT content FROM test_table WHERE filename = 'size' FOR UPDATE")
+    lob = cursor.fetch[0]
+    assert_equal(0, lob.size)
+    lob.write('0123456789')
+    assert_equal(10, lob.size)
+    lob.seek(5)
+    lob.write('abc')
+    assert_equal(10, lob.size)
+    lob.write('defghi')
+    assert_equal(14, lob.size)
+    lob.truncate(4)
+    assert_equal(4, lob.size)
+    lob.rewind
+    assert_equal('0123', lob.read)
+    lob.close
+    cursor.close
+  end
+
+  def test_lob_prefetch_size
+    return if $oracle_version < OCI8::ORAVER_11_1
+    @conn.exec("INSERT INTO test_table(filename, content) VALUES ('short', 'short clob')")
+    cursor = @conn.parse("SELECT content FROM test_table WHERE filename = 'short'")
+    assert_equal(0, cursor.lob_prefetch_size)
+    assert_raise(ArgumentError) { cursor.lob_prefetch_size = -1 }
+    cursor.lob_prefetch_size = 4000
+    assert_equal(4000, cursor.lob_prefetch_size)
+    cursor.exec
+    lob = cursor.fetch[0]
+    assert_equal(10, lob.size)
+    assert_equal('short clob', lob.read)
+    lob.close
+    cursor.close
+  end
+
+  def test_lob_as_string_size
+    @conn.exec("INSERT INTO test_table(filename, content) VALUES ('short', 'short clob')")
+    @conn.exec("INSERT INTO test_table(filename, content) VALUES ('null', NULL)")
+    cursor = @conn.parse("SELECT filename, content FROM test_table ORDER BY filename")
+    cursor.lob_as_string_size = 100
+    cursor.exec
+    assert_equal(['null', nil], cursor.fetch)
+    assert_equal(['short', 'short clob'], cursor.fetch)
+    assert_nil(cursor.fetch)
+    cursor.close
+
+    cursor = @conn.parse("SELECT content FROM test_table WHERE filename = 'short'")
+    cursor.define(1, :clob_as_string, 5)
+    cursor.exec
+    assert_equal(['short'], cursor.fetch) # truncated
+    cursor.close
+  end
+
   def teardown
     drop_table('test_table')
     @conn.logoff
@@ -156,6 +156,64 @@ EOS
     end
   end
 
+  def test_timestamp_tz_select_array
+    dates = ['1900-02-28 12:34:56.123456789 +09:00',
+             '1969-12-31 23:59:59.999999999 -05:00',
+             '2000-02-29 00:00:00.000000001 +00:00',
+             '2038-01-19 03:14:08.500000000 +05:30',
+             '9999-12-31 23:59:59.000000000 -12:00']
+    cursor = @conn.parse(dates.collect do |date|
+                           "SELECT TO_TIMESTAMP_TZ('#{date}', 'YYYY-MM-DD HH24:MI:SS.FF TZH:TZM') FROM dual"
+                         end.join(' UNION ALL ') + ' UNION ALL SELECT NULL FROM dual')
+    cursor.define(1, Time)
+    cursor.fetch_array_size = 10
+    cursor.exec
+    dates.each do |date|
+      val = cursor.fetch[0]
+      assert_kind_of(Time, val)
+      assert_equal(string_to_time(date), val)
+      assert_equal(string_to_time(date).utc_offset, val.utc_offset)
+    end
+    assert_equal([nil], cursor.fetch)
+    assert_nil(cursor.fetch)
+    cursor.close
+  end
+
+  def test_raw_timestamp_select
+    return unless defined? OCI8::BindType::RawTimestamp
+    saved = OCI8::BindType::Mapping.values_at(:timestamp, :timestamp_tz, Time)
+    begin
+      OCI8::BindType::Mapping[:timestamp] = OCI8::BindType::RawTimestamp
+      OCI8::BindType::Mapping[:timestamp_tz] = OCI8::BindType::RawTimestampTZ
+      OCI8::BindType::Mapping[Time] = OCI8::BindType::RawTimestampTZ
+      ['1900-02-28 12:34:56.123456789 +09:00',
+       '1969-12-31 23:59:59.000000000 -05:30',
+       '2038-01-19 03:14:08.500000000 +05:30'].each do |date|
+        @conn.exec(<<-EOS) do |row|
+SELECT TO_TIMESTAMP_TZ('#{date}', 'YYYY-MM-DD HH24:MI:SS.FF TZH:TZM'),
+       TO_TIMESTAMP('#{date[0, 29]}', 'YYYY-MM-DD HH24:MI:SS.FF'),
+       CAST(NULL AS TIMESTAMP)
+  FROM dual
+EOS
+          assert_equal(string_to_time(date), row[0])
+          assert_equal(string_to_time(date).utc_offset, row[0].utc_offset)
+          assert_equal(string_to_time(date[0, 29]), row[1])
+          assert_nil(row[2])
+        end
+      end
+      time = Time.new(2012, 3, 4, 5, 6, Rational(29, 4), '-05:30')
+      cursor = @conn.parse('BEGIN :out := :in; END;')
+      cursor.bind_param(:in, time)
+      cursor.bind_param(:out, nil, Time)
+      cursor.exec
+      assert_equal(time, cursor[:out])
+      assert_equal(time.utc_offset, cursor[:out].utc_offset)
+      cursor.close
+    ensure
+      OCI8::BindType::Mapping[:timestamp], OCI8::BindType::Mapping[:timestamp_tz], OCI8::BindType::Mapping[Time] = saved
+    end
+  end
+
   def test_timestamp_tz_out_bind
     cursor = @conn.parse(<<-EOS)
 BEGIN
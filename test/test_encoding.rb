@@ -71,6 +71,28 @@ EOS
     drop_table('test_table')
   end
 
+  def test_select_ascii_only
+    # longer than a machine word to cover the word-at-a-time check.
+    ascii = 'abcdefghijklmnopqrstuvwxyz'
+    @conn.exec("SELECT :1 FROM DUAL", ascii) do |row|
+      assert_equal(ascii, row[0])
+      assert_equal(OCI8.encoding, row[0].encoding)
+      assert(row[0].ascii_only?)
+    end
+    if OCI8.encoding.name == "UTF-8"
+      [0, 1, 7, 8, 9, 25].each do |pos|
+        utf_8 = ascii.dup
+        utf_8[pos] = "\u00A1"
+        @conn.exec("SELECT :1 FROM DUAL", utf_8) do |row|
+          assert_equal(utf_8, row[0])
+          assert_equal(OCI8.encoding, row[0].encoding)
+          assert(!row[0].ascii_only?, "non-ASCII at #{pos}")
+          assert(row[0].valid_encoding?)
+        end
+      end
+    end
+  end
+
   if OCI8.encoding.name == "UTF-8"
     def test_bind_string_with_code_conversion
       drop_table('test_table')
@@ -166,6 +166,125 @@ EOS
     drop_table('test_table')
   end
 
+  def test_fetch_hash_keys
+    cursor = @conn.parse('SELECT 1 AS a, 2 AS b FROM dual UNION ALL SELECT 3, 4 FROM dual')
+    cursor.exec
+    row1 = cursor.fetch_hash
+    row2 = cursor.fetch_hash
+    assert_equal({'A' => 1, 'B' => 2}, row1)
+    assert_equal({'A' => 3, 'B' => 4}, row2)
+    assert(row1.keys.all? { |key| key.frozen? })
+    assert_same(row1.keys[0], row2.keys[0])
+    assert_nil(cursor.fetch_hash)
+    cursor.exec
+    assert_equal({:A => 1, :B => 2}, cursor.fetch_hash(:symbolize_keys => true))
+    assert_equal([{'A' => 3, 'B' => 4}], cursor.enum_for(:fetch_hash).to_a)
+    cursor.close
+  end
+
+  def test_fetch_row
+    cursor = @conn.parse(<<-EOS)
+SELECT 1 AS id, 'abc' AS str, CAST(NULL AS VARCHAR2(10)) AS null_str,
+       CAST(1.25 AS NUMBER(20,10)) AS amount, TO_DATE('2010-01-02', 'YYYY-MM-DD') AS dt
+  FROM dual
+UNION ALL
+SELECT 2, 'defg', 'x', 2.5, TO_DATE('2011-01-02', 'YYYY-MM-DD') FROM dual
+EOS
+    cursor.exec
+    row1 = cursor.fetch_row
+    row2 = cursor.fetch_row
+    assert_nil(cursor.fetch_row)
+    assert_kind_of(OCI8::Row, row1)
+    assert_equal(5, row1.size)
+    assert_equal('defg', row2[:STR])
+    assert_equal(1, row1[0])
+    assert_equal('abc', row1['STR'])
+    assert_same(row1['STR'], row1[1])
+    assert_nil(row1[:NULL_STR])
+    assert_equal('x', row2[-3])
+    assert_equal(BigDecimal('1.25'), row1[:AMOUNT])
+    assert_equal(Time.local(2011, 1, 2), row2[:DT])
+    assert_nil(row1[:NO_SUCH_COLUMN])
+    assert_nil(row1[5])
+    assert_equal([2, 'defg', 'x', BigDecimal('2.5'), Time.local(2011, 1, 2)], row2.to_a)
+    assert_equal({'ID' => 1, 'STR' => 'abc', 'NULL_STR' => nil, 'AMOUNT' => BigDecimal('1.25'), 'DT' => Time.local(2010, 1, 2)}, row1.to_h)
+    cursor.close
+  end
+
+  def test_string_dedup
+    drop_table('test_table')
+    @conn.exec('CREATE TABLE test_table (id NUMBER(38), status VARCHAR2(10))')
+    cursor = @conn.parse('INSERT INTO test_table VALUES (:1, :2)')
+    1.upto(30) do |i|
+      cursor.exec(i, (i % 10 == 0) ? nil : %w[NEW PAID SHIPPED][i % 3])
+    end
+    cursor.close
+
+    cursor = @conn.parse('SELECT id, status FROM test_table ORDER BY id')
+    cursor.string_dedup_size = 8
+    cursor.fetch_array_size = 7
+    cursor.exec
+    rows = cursor.fetch_many(100)
+    assert_equal(30, rows.size)
+    statuses = rows.collect { |row| row[1] }
+    assert_equal((1..30).collect { |i| (i % 10 == 0) ? nil : %w[NEW PAID SHIPPED][i % 3] }, statuses)
+    assert(statuses.compact.all? { |val| val.frozen? })
+    assert_same(statuses[0], statuses[3])
+    assert_equal([nil, [24, 3]], cursor.string_dedup_stats)
+    cursor.close
+
+    cursor = @conn.exec('SELECT status FROM test_table ORDER BY id')
+    assert(!cursor.fetch[0].frozen?)
+    assert_equal([nil], cursor.string_dedup_stats)
+    cursor.close
+    drop_table('test_table')
+  end
+
+  def test_dynamic_string_size
+    drop_table('test_table')
+    @conn.exec('CREATE TABLE test_table (id NUMBER(38), val VARCHAR2(4000))')
+    values = (1..30).collect do |i|
+      case i % 10
+      when 0; nil
+      when 5; 'x' * (i * 100) # longer than the inline buffer
+      else; "value #{i}"
+      end
+    end
+    cursor = @conn.parse('INSERT INTO test_table VALUES (:1, :2)')
+    cursor.bind_param(1, nil, Integer)
+    cursor.bind_param(2, nil, String, 4000)
+    values.each_with_index do |val, i|
+      cursor[1] = i + 1
+      cursor[2] = val
+      cursor.exec
+    end
+    cursor.close
+
+    cursor = @conn.parse('SELECT id, val FROM test_table ORDER BY id')
+    cursor.fetch_array_size = 7
+    cursor.exec
+    assert_equal(values, cursor.fetch_many(100).collect { |row| row[1] })
+    fixed_size = cursor.define_bytes_allocated
+    cursor.close
+
+    cursor = @conn.parse('SELECT id, val FROM test_table ORDER BY id')
+    cursor.fetch_array_size = 7
+    cursor.dynamic_string_size = 16
+    assert_equal(16, cursor.dynamic_string_size)
+    cursor.exec
+    assert(cursor.define_bytes_allocated < fixed_size)
+    assert_equal(values, cursor.fetch_many(100).collect { |row| row[1] })
+    assert(cursor.define_bytes_allocated < fixed_size)
+    cursor.close
+
+    cursor = @conn.parse('SELECT val FROM test_table ORDER BY id')
+    cursor.dynamic_string_size = 16
+    cursor.exec
+    assert_equal(values, (1..30).collect { cursor.fetch_row[0] })
+    cursor.close
+    drop_table('test_table')
+  end
+
   def test_bind_cursor
     # FIXME: check again after upgrading Oracle 9.2 to 9.2.0.4.
     return if $oracle_version < OCI8::ORAVER_10_1
@@ -431,4 +550,294 @@ EOS
     end
   end
 
+  def test_fetch_array_size
+    drop_table('test_table')
+    @conn.exec('CREATE TABLE test_table (id NUMBER(38), str VARCHAR2(20), dt DATE)')
+    cursor = @conn.parse('INSERT INTO test_table VALUES (:1, :2, :3)')
+    1.upto(25) do |i|
+      dt = (i % 3 == 0) ? [nil, OraDate] : OraDate.new(2000, 1, i)
+      str = (i % 5 == 0) ? [nil, String] : "row#{i}"
+      cursor.exec(i, str, dt)
+    end
+    cursor.close
+
+    [1, 4, 10, 25, 100].each do |size|
+      cursor = @conn.parse('SELECT * FROM test_table ORDER BY id')
+      cursor.fetch_array_size = size
+      assert_equal(size, cursor.fetch_array_size)
+      cursor.define(3, Time)
+      cursor.exec
+      1.upto(25) do |i|
+        rv = cursor.fetch
+        assert_equal(i, rv[0])
+        assert_equal((i % 5 == 0) ? nil : "row#{i}", rv[1])
+        assert_equal((i % 3 == 0) ? nil : Time.local(2000, 1, i), rv[2])
+      end
+      assert_nil(cursor.fetch)
+      assert_nil(cursor.fetch)
+      # re-execute
+      cursor.exec
+      ids = []
+      cursor.fetch_hash do |row|
+        ids << row['ID']
+      end
+      assert_equal((1..25).to_a, ids)
+      cursor.close
+    end
+    drop_table('test_table')
+
+    # rows fetched before an error are returned before the error is raised.
+    [1, 4, 100].each do |size|
+      cursor = @conn.parse('SELECT 1 / (10 - LEVEL) FROM DUAL CONNECT BY LEVEL <= 20')
+      cursor.fetch_array_size = size
+      cursor.define(1, Float)
+      cursor.exec
+      1.upto(9) do |i|
+        assert_in_delta(1.0 / (10 - i), cursor.fetch[0], 1e-12)
+      end
+      assert_raise(OCIError) { cursor.fetch }
+      cursor.close
+    end
+  end
+
+  def test_fetch_many_and_fetch_columns
+    drop_table('test_table')
+    @conn.exec('CREATE TABLE test_table (id NUMBER(38), str VARCHAR2(20))')
+    cursor = @conn.parse('INSERT INTO test_table VALUES (:1, :2)')
+    1.upto(25) do |i|
+      cursor.exec(i, (i % 5 == 0) ? [nil, String] : "row#{i}")
+    end
+    cursor.close
+    ids = (1..25).to_a
+    strs = ids.collect { |i| (i % 5 == 0) ? nil : "row#{i}" }
+
+    [nil, 7, 100].each do |size|
+      cursor = @conn.parse('SELECT * FROM test_table ORDER BY id')
+      cursor.fetch_array_size = size
+      cursor.exec
+      rows = []
+      while r = cursor.fetch_many(10)
+        assert(r.size <= 10)
+        rows.concat(r)
+      end
+      assert_equal(ids.zip(strs), rows)
+      assert_nil(cursor.fetch_many(10))
+
+      cursor.exec
+      assert_equal([1, 'row1'], cursor.fetch)
+      cols = cursor.fetch_columns(20)
+      assert_equal([ids[1, 20], strs[1, 20]], cols)
+      cols = cursor.fetch_columns(20)
+      assert_equal([ids[21, 4], strs[21, 4]], cols)
+      assert_nil(cursor.fetch_columns(20))
+      assert_raise(ArgumentError) { cursor.fetch_many(0) }
+      cursor.close
+    end
+    drop_table('test_table')
+  end
+
+  def test_reduce_columns
+    drop_table('test_table')
+    @conn.exec('CREATE TABLE test_table (id NUMBER(38), amount NUMBER(38,10), dbl BINARY_DOUBLE, str VARCHAR2(20))')
+    cursor = @conn.parse('INSERT INTO test_table VALUES (:1, :2, :3, :4)')
+    1.upto(25) do |i|
+      amount = (i % 5 == 0) ? [nil, OraNumber] : OraNumber("#{i}.#{i}")
+      dbl = (i % 7 == 0) ? [nil, Float] : i * 0.5
+      cursor.exec(i, amount, dbl, "row#{i}")
+    end
+    cursor.close
+    amounts = (1..25).reject { |i| i % 5 == 0 }.collect { |i| BigDecimal("#{i}.#{i}") }
+    dbls = (1..25).reject { |i| i % 7 == 0 }.collect { |i| i * 0.5 }
+
+    [nil, 7, 100].each do |size|
+      cursor = @conn.parse('SELECT * FROM test_table ORDER BY id')
+      cursor.fetch_array_size = size
+      cursor.define(2, OraNumber)
+      cursor.exec
+      assert_equal([1, 'row1'], cursor.fetch.values_at(0, 3))
+      result = cursor.reduce_columns(:sum, :sum, :sum, :count)
+      assert_equal((2..25).inject(:+), result[0])
+      assert_equal(amounts[1..-1].inject(:+), result[1].to_d)
+      assert_equal(dbls[1..-1].inject(:+), result[2])
+      assert_equal(24, result[3])
+      assert_nil(cursor.fetch)
+
+      cursor.exec
+      assert_equal([1, nil], cursor.reduce_columns(:min, nil))
+      cursor.exec
+      assert_equal(25, cursor.aggregate(1, :max))
+      cursor.exec
+      assert_equal(amounts.max, cursor.aggregate(2, :max).to_d)
+      cursor.exec
+      assert_equal(dbls.min, cursor.aggregate(3, :min))
+      cursor.exec
+      assert_equal(20, cursor.aggregate(2, :count))
+      assert_raise(ArgumentError) { cursor.aggregate(0, :sum) }
+      assert_raise(ArgumentError) { cursor.aggregate(5, :sum) }
+      cursor.exec
+      assert_raise(TypeError) { cursor.reduce_columns(nil, nil, nil, :sum) }
+      assert_raise(ArgumentError) { cursor.reduce_columns(:avg) }
+      cursor.close
+    end
+    drop_table('test_table')
+  end
+
+  def test_fetch_packed
+    drop_table('test_table')
+    @conn.exec('CREATE TABLE test_table (id NUMBER(38), amount NUMBER(10,2), dbl BINARY_DOUBLE, str VARCHAR2(20))')
+    cursor = @conn.parse('INSERT INTO test_table VALUES (:1, :2, :3, :4)')
+    1.upto(25) do |i|
+      amount = (i % 5 == 0) ? [nil, Float] : i * 1.25
+      dbl = (i % 7 == 0) ? [nil, Float] : i * 0.5
+      cursor.exec(i, amount, dbl, "row#{i}")
+    end
+    cursor.close
+    ids = (1..25).to_a
+    amounts = (1..25).collect { |i| (i % 5 == 0) ? 0.0 : i * 1.25 }
+    dbls = (1..25).collect { |i| (i % 7 == 0) ? 0.0 : i * 0.5 }
+    # rows 7, 14 and 21 are packed at 6, 12 and 19 because row 11 is fetched by #fetch.
+    dbl_nulls = [0x40, 0x10, 0x08].pack('C*')
+
+    [nil, 7, 100].each do |size|
+      cursor = @conn.parse('SELECT * FROM test_table ORDER BY id')
+      cursor.fetch_array_size = size
+      cursor.define(1, Integer)
+      cursor.define(2, Float)
+      cursor.exec
+      id_buf = ''.force_encoding('ASCII-8BIT')
+      amount_buf = ''.force_encoding('ASCII-8BIT')
+      dbl_buf = ''.force_encoding('ASCII-8BIT')
+      null_buf = ''.force_encoding('ASCII-8BIT')
+      assert_equal(10, cursor.fetch_packed(10, id_buf, amount_buf, [dbl_buf, null_buf]))
+      assert_equal(ids[0, 10], id_buf.unpack('q*'))
+      assert_equal(['row11'], cursor.fetch.values_at(3))
+      assert_equal(14, cursor.fetch_packed(100, id_buf, amount_buf, [dbl_buf, null_buf]))
+      assert_nil(cursor.fetch_packed(100, id_buf))
+      assert_equal(ids[0, 10] + ids[11..-1], id_buf.unpack('q*'))
+      assert_equal(amounts[0, 10] + amounts[11..-1], amount_buf.unpack('D*'))
+      assert_equal(dbls[0, 10] + dbls[11..-1], dbl_buf.unpack('D*'))
+      assert_equal(dbl_nulls, null_buf)
+
+      cursor.exec
+      assert_raise(TypeError) { cursor.fetch_packed(1, nil, nil, nil, ''.force_encoding('ASCII-8BIT')) }
+      assert_raise(ArgumentError) { cursor.fetch_packed(0, nil) }
+      assert_raise(ArgumentError) { cursor.fetch_packed(1, nil, nil, nil, nil, nil) }
+      cursor.close
+    end
+
+    # no string is changed when a value in the batch exceeds 64-bit range.
+    @conn.exec('INSERT INTO test_table VALUES (:1, 1, 1, NULL)', 2**64)
+    cursor = @conn.parse('SELECT amount, id FROM test_table ORDER BY id')
+    cursor.fetch_array_size = 100
+    cursor.define(1, Float)
+    cursor.define(2, Integer)
+    cursor.exec
+    amount_buf = ''.force_encoding('ASCII-8BIT')
+    id_buf = ''.force_encoding('ASCII-8BIT')
+    assert_raise(RangeError) { cursor.fetch_packed(100, amount_buf, id_buf) }
+    assert_equal('', amount_buf)
+    assert_equal('', id_buf)
+    assert_raise(RangeError) { cursor.fetch_packed(100, amount_buf, id_buf) }
+    assert_equal('', amount_buf)
+    assert_equal('', id_buf)
+    cursor.close
+    drop_table('test_table')
+  end
+
+  class UpcaseString < OCI8::BindType::String
+    def get()
+      (val = super()) && val.upcase
+    end
+  end
+
+  def test_overridden_bind_type_methods
+    cursor = @conn.parse("SELECT 'abc', TO_DATE('2011-09-01', 'YYYY-MM-DD') FROM DUAL")
+    cursor.define(1, UpcaseString, 3)
+    cursor.define(2, Date)
+    cursor.exec
+    assert_equal(['ABC', Date.civil(2011, 9, 1)], cursor.fetch)
+    cursor.close
+
+    cursor = @conn.parse("BEGIN :out := :in + 1; END;")
+    cursor.bind_param(:in, Date.civil(2011, 9, 1))
+    cursor.bind_param(:out, nil, Date)
+    cursor.exec
+    assert_equal(Date.civil(2011, 9, 2), cursor[:out])
+    cursor.close
+  end
+
+  def test_statement_cache
+    drop_table('test_table')
+    @conn.exec('CREATE TABLE test_table (id NUMBER(38), str VARCHAR2(20))')
+    assert_equal(0, @conn.statement_cache_size)
+    @conn.statement_cache_size = 2
+    insert_sql = 'INSERT INTO test_table VALUES (:1, :2)'
+    1.upto(10) do |i|
+      @conn.exec(insert_sql, i, 'x' * i)
+    end
+    assert_equal(9, @conn.statement_cache_hits)
+    assert_equal(1, @conn.statement_cache_misses)
+
+    select_sql = 'SELECT str FROM test_table WHERE id = :1'
+    1.upto(10) do |i|
+      assert_equal(['x' * i], @conn.select_one(select_sql, i))
+    end
+    assert_equal(18, @conn.statement_cache_hits)
+    assert_equal(2, @conn.statement_cache_misses)
+
+    # a cursor returned to the caller isn't cached.
+    cursor = @conn.exec('SELECT id FROM test_table ORDER BY id')
+    assert_equal([1], cursor.fetch)
+    cursor.close
+
+    # the least recently used cursor is evicted.
+    @conn.exec('SELECT * FROM DUAL') { |row| }
+    @conn.select_one(select_sql, 1)
+    @conn.exec(insert_sql, 11, 'y')
+    assert_equal(19, @conn.statement_cache_hits)
+    assert_equal(5, @conn.statement_cache_misses)
+
+    # errors don't keep broken cursors.
+    assert_raise(OCIError) { @conn.exec(insert_sql, 1, 'z' * 30) }
+    @conn.exec(insert_sql, 12, 'z')
+    assert_equal(12, @conn.select_one('SELECT COUNT(*) FROM test_table')[0])
+
+    @conn.statement_cache_size = 0
+    assert_raise(ArgumentError) { @conn.statement_cache_size = -1 }
+    drop_table('test_table')
+  end
+
+  def test_statement_cache_logoff
+    conn = get_oci8_connection
+    conn.statement_cache_size = 2
+    conn.exec('SELECT * FROM DUAL') { |row| }
+    assert_equal(1, conn.instance_variable_get(:@statement_cache).size)
+    conn.logoff
+    assert_equal(0, conn.instance_variable_get(:@statement_cache).size)
+  end
+
+  def test_reexecute_reuses_column_metadata
+    cols = (1..20).collect { |i| "#{i} c#{i}" }.join(', ')
+    cursor = @conn.parse("SELECT #{cols} FROM DUAL")
+    cursor.exec
+    metadata = cursor.column_metadata.dup
+    cursor.fetch
+    cursor.exec
+    # the same metadata objects are kept.
+    cursor.column_metadata.each_with_index do |md, i|
+      assert_same(metadata[i], md)
+    end
+    assert_equal((1..20).to_a, cursor.fetch)
+
+    if defined? GC.stat and GC.stat.has_key? :total_allocated_objects
+      GC.start
+      before = GC.stat[:total_allocated_objects]
+      cursor.exec
+      allocated = GC.stat[:total_allocated_objects] - before
+      # Describing 20 columns needs more than 20 objects.
+      assert_operator(allocated, :<, 20)
+    end
+    cursor.close
+  end
+
 end # TestOCI8
@@ -438,6 +438,50 @@ EOS
     compare_with_float(LARGE_RANGE_VALUES, OraNumber, Proc.new {|n| n.abs})
   end
 
+  # results computed without OCI must be same with BigDecimal.
+  def test_exact_arithmetic
+    srand(20111017)
+    values = (1..200).collect do
+      digits = (1..(rand(19) + 1)).collect { rand(10) }.join
+      x = "0.#{digits}e#{rand(40) - 20}"
+      rand(2) == 0 ? x : '-' + x
+    end
+    values << '0'
+    values.each_slice(2) do |x, y|
+      bx = BigDecimal(x)
+      by = BigDecimal(y)
+      ox = OraNumber(x)
+      oy = OraNumber(y)
+      assert_equal(bx + by, (ox + oy).to_d, "#{x} + #{y}")
+      assert_equal(bx - by, (ox - oy).to_d, "#{x} - #{y}")
+      assert_equal(bx * by, (ox * oy).to_d, "#{x} * #{y}")
+      assert_equal(bx <=> by, ox <=> oy, "#{x} <=> #{y}")
+      assert_equal(-bx, (-ox).to_d, "-#{x}")
+      assert_equal(bx.abs, ox.abs.to_d, "#{x}.abs")
+      assert_equal(bx.floor, ox.floor, "#{x}.floor")
+      assert_equal(bx.ceil, ox.ceil, "#{x}.ceil")
+      n = rand(40) - 20
+      assert_equal(bx.round(n, BigDecimal::ROUND_HALF_UP), ox.round(n).to_d, "#{x}.round(#{n})")
+      assert_equal(bx.truncate(n), ox.truncate(n).to_d, "#{x}.truncate(#{n})")
+    end
+  end
+
+  def test_hash_key
+    h = {}
+    LARGE_RANGE_VALUES.each do |x|
+      h[OraNumber(x)] = x
+    end
+    LARGE_RANGE_VALUES.each do |x|
+      assert_equal(x, h[OraNumber(x)], x)
+      assert(OraNumber(x).eql?(OraNumber(x)), x)
+      assert_equal(OraNumber(x).hash, OraNumber(x).hash, x)
+    end
+    assert(!OraNumber(1).eql?(1))
+    assert(!OraNumber(1).eql?(OraNumber(2)))
+    assert_equal(LARGE_RANGE_VALUES.collect { |x| BigDecimal(x) }.sort,
+                 LARGE_RANGE_VALUES.collect { |x| OraNumber(x) }.sort.collect { |x| x.to_d })
+  end
+
   # onum.ceil -> integer
   def test_ceil
     compare_with_float(LARGE_RANGE_VALUES, Integer, Proc.new {|n| n.ceil})
@@ -527,6 +571,51 @@ EOS
     end
   end
 
+  # onum.to_f must be same with String#to_f when
+  # float_conversion_type is :ruby.
+  def test_to_f_random
+    return if OCI8.properties[:float_conversion_type] != :ruby
+    srand(20111017)
+    5000.times do
+      digits = (1..(rand(38) + 1)).collect { rand(10) }.join
+      pos = rand(digits.length + 1)
+      x = digits[0, pos] + '.' + digits[pos..-1]
+      x = '0' + x if pos == 0
+      x += 'e' + (rand(160) - 80).to_s if rand(3) == 0
+      x = '-' + x if rand(2) == 0
+      assert_equal(x.to_f, OraNumber.new(x).to_f, x)
+    end
+  end
+
+  # values near halfway between two doubles and 38-digit values.
+  def test_to_f_halfway
+    return if OCI8.properties[:float_conversion_type] != :ruby
+    ['9007199254740993', '9007199254740995', '-9007199254740993',
+     '1.000000000000000055511151231257827', '0.33333333333333333333333333333333333333',
+     '2.225073858507201e-125', '9.9999999999999999999999999999999999999e125',
+     '1e-130', '123456789.01234567890123456789012345678e-100'].each do |x|
+      assert_equal(x.to_f, OraNumber.new(x).to_f, x)
+    end
+  end
+
+  # OraNumber.new(float) must be same with OraNumber.new(float.to_s)
+  # when float_conversion_type is :ruby.
+  def test_new_from_float_random
+    return if OCI8.properties[:float_conversion_type] != :ruby
+    srand(20111017)
+    5000.times do
+      x = [rand(2**64)].pack('Q').unpack('D')[0]
+      next if x.nan? or x.infinite? or x.abs >= 1e126
+      assert_equal(OraNumber.new(x.to_s), OraNumber.new(x), x.to_s)
+      x = rand(1000000) / 100.0
+      assert_equal(OraNumber.new(x.to_s), OraNumber.new(x), x.to_s)
+    end
+    (-400..400).each do |n|
+      x = 2.0 ** n
+      assert_equal(OraNumber.new(x.to_s), OraNumber.new(x), x.to_s)
+    end
+  end
+
   # onum.to_i -> integer
   def test_to_i
     LARGE_RANGE_VALUES.each do |x|
@@ -536,6 +625,46 @@ EOS
     end
   end
 
+  # random integer strings from 1 to 38 digits, sometimes followed by
+  # zeros which are not stored in the mantissa.
+  def random_integer_strings(count)
+    srand(20111017)
+    values = []
+    count.times do
+      val = (1..(rand(38) + 1)).collect { rand(10) }.join.sub(/^0+(?=.)/, '')
+      val += '0' * rand(88) if rand(4) == 0
+      val = '-' + val if rand(2) == 0 && val != '0'
+      values << val
+    end
+    values
+  end
+
+  # onum.to_i must be same with the conversion via a string.
+  def test_to_i_random
+    random_integer_strings(5000).each do |x|
+      assert_equal(x.to_i, OraNumber.new(x).to_i, x)
+      y = x + '.' + rand(10 ** 10).to_s
+      assert_equal(x.to_i, OraNumber.new(y).to_i, y)
+    end
+  end
+
+  def test_integer_out_bind_random
+    conn = get_oci8_connection
+    begin
+      conn.exec("alter session set nls_numeric_characters = '.,'")
+      cursor = conn.parse("BEGIN :out := TO_NUMBER(:in); END;")
+      cursor.bind_param(:out, nil, Integer)
+      cursor.bind_param(:in, nil, String, 130)
+      random_integer_strings(500).each do |val|
+        cursor[:in] = val
+        cursor.exec
+        assert_equal(val.to_i, cursor[:out], val)
+      end
+    ensure
+      conn.logoff
+    end
+  end
+
   # onum.to_s -> string
   def test_to_s
     LARGE_RANGE_VALUES.each do |x|
@@ -712,6 +841,30 @@ EOS
     end
   end
 
+  def test_new_from_bignum
+    srand(20111017)
+    1000.times do
+      x = rand(10 ** (rand(106) + 20)) * (rand(2) == 0 ? 1 : -1)
+      assert_equal(OraNumber.new(x.to_s).dump, OraNumber.new(x).dump, x.to_s)
+    end
+    assert_raise OCIError do
+      OraNumber.new(10 ** 126)
+    end
+  end
+
+  def test_bigdecimal_round_trip
+    LARGE_RANGE_VALUES.each do |val|
+      assert_equal(BigDecimal(val), OraNumber.new(BigDecimal(val)).to_d, val)
+    end
+    srand(20111017)
+    1000.times do
+      x = rand(10 ** 38) * (rand(2) == 0 ? 1 : -1)
+      assert_equal(x, OraNumber.new(x).to_i, x.to_s)
+      x = BigDecimal(x) / (10 ** 10) # NUMBER(38,10)
+      assert_equal(x, OraNumber.new(x).to_d, x.to_s)
+    end
+  end
+
   def test_new_from_rational
     [
      [Rational(1, 2), "0.5"],